@@ -0,0 +1,217 @@
+// Microbenchmarks of the testbed itself: its primitives, the overhead of each test measured on a null model, and
+// its throughput and memory across the reference models. With --scaling, it instead measures how independent
+// model instances scale across up to the given number of cores (0 for all of them). With --serving, it simulates
+// serving the given number of sessions of a reference model under open-loop load. With --latency, it times single
+// steps of a reference model at several ages. --compare reports the changes since an earlier --json file.
+//
+//     g++ -std=c++23 -O2 -pthread -o agitb_bench bench/bench.cpp
+//     ./agitb_bench [--filter <text>] [--repetitions <n>] [--json <file>] [--compare <file>]
+//     ./agitb_bench --latency <model> [--repetitions <n>] [--json <file>] [--compare <file>]
+//     ./agitb_bench --scaling <instances> [--steps <n>] [--json <file>]
+//     ./agitb_bench --serving <sessions> [--model <name>] [--rate <inputs/s>] [--arrivals poisson|fixed]
+//                   [--workers <n>] [--duration <ms>] [--json <file>]
+
+#include "../include/agitb.h"
+#include "benchmark.h"
+#include "models.h"
+#include "scaling.h"
+#include "serving.h"
+#include "latency.h"
+
+#include <fstream>
+#include <cstring>
+
+namespace AGI = sprogar::AGI;
+namespace bench = sprogar::AGI::bench;
+namespace utils = sprogar::AGI::utils;
+
+using Input = bench::Input;
+using InputSequence = utils::InputSequence<Input>;
+template <typename M>
+using Model = utils::Model<M, Input, AGI::SimulatedInfinity>;
+
+void primitives(bench::Suite& suite)
+{
+    utils::rng.seed(1);
+
+    suite.measure("utils::random_p", []() { bench::keep(utils::random_p<Input>(0.3)); });
+    suite.measure("InputSequence(random)", []() { bench::keep(InputSequence(InputSequence::random, AGI::SequenceLength)); });
+    suite.measure("InputSequence(circular_random)", []() { bench::keep(InputSequence(InputSequence::circular_random, AGI::SequenceLength)); });
+    suite.measure("InputSequence(trivial)", []() { bench::keep(InputSequence(InputSequence::trivial, AGI::SequenceLength)); });
+    const InputSequence motif(InputSequence::random, 3);
+    suite.measure("InputSequence(periodic)", [&]() { bench::keep(InputSequence(InputSequence::periodic, motif, 10 * AGI::SequenceLength)); });
+
+    Model<bench::NullModel> M;
+    const InputSequence inputs(InputSequence::random, AGI::SequenceLength);
+    suite.measure("Model::process", [&]() { bench::keep(M.process(inputs)); });
+
+    const InputSequence a(InputSequence::random, 100), b(InputSequence::random, 100);
+    suite.measure("utils::match_score (100 inputs)", [&]() { bench::keep(utils::match_score(a, b)); });
+
+    std::vector<utils::time_t> early(100), late(100);
+    for (size_t i = 0; i < early.size(); ++i) {
+        early[i] = utils::random(100, 200);
+        late[i] = utils::random(100, 210);
+    }
+    suite.measure("utils::percentiles (100 times)", [&]() { std::vector<utils::time_t> times = early; bench::keep(utils::percentiles(times)); });
+    suite.measure("utils::consistently_greater_second_value", [&]() { bench::keep(utils::consistently_greater_second_value(early, late)); });
+}
+
+// One repetition of each test from a fixed seed; the null model fails some of them early, which the names tell.
+// Whether it does is only found out for the tests the filter may let through.
+// Test #12 is left out: it sizes its chunks by the step cost of the model, which the null model does not have.
+void harness_overhead(bench::Suite& suite)
+{
+    for (size_t i = 0; i < 11; ++i) {
+        auto name = [i](bool passes) { return std::format("test #{} (null model, {})", i + 1, passes ? "passes" : "fails"); };
+        if (not suite.selects(name(true)) and not suite.selects(name(false)))
+            continue;
+        suite.measure(name(not AGI::TestBed<bench::NullModel>::attempt(i, 1)),
+            [i]() { bench::keep(AGI::TestBed<bench::NullModel>::attempt(i, 1)); });
+    }
+}
+
+// The cost of a step and of a copy of the model, with its footprint, and the time of a repetition of the tests
+// that exercise the testbed rather than the learning ability of the model. The footprint, as the testbed measures
+// it, is only measured if the step is benchmarked.
+template <typename M>
+void chart(bench::Suite& suite)
+{
+    static constexpr size_t ChartedTests[] = { 2, 3, 4, 5, 7 };
+    const std::string name = M::name;
+
+    Model<M> model;
+    const InputSequence inputs(InputSequence::random, 1 << 10);
+    size_t k = 0;
+    if (suite.selects(name + ": step"))
+        suite.measure(name + ": step", [&]() { bench::keep(model(inputs[k++ % inputs.size()])); }, AGI::TestBed<M>::model_footprint());
+    suite.measure(name + ": copy", [&]() { const Model<M> copy = model; bench::keep(copy); });
+    for (size_t test : ChartedTests)
+        suite.measure(std::format("{}: test #{}", name, test), [test]() { bench::keep(AGI::TestBed<M>::attempt(test - 1, 1)); });
+}
+
+using Zoo = std::tuple<bench::NullModel, bench::CounterModel, bench::HashedHistoryModel,
+    bench::NGramModel<2>, bench::NGramModel<3>, bench::NGramModel<3, 16>,
+    bench::SyntheticModel<64, 0, 0>, bench::SyntheticModel<64, 1000, 0>, bench::SyntheticModel<64, 0, 10000>,
+    bench::SyntheticModel<4096, 0, 0>, bench::SyntheticModel<65536, 0, 0>>;
+
+// Calls f.template operator()<M>() for the reference model M of the given name; returns false if there is none.
+template <typename Func>
+bool with_model(const std::string& name, Func&& f)
+{
+    return std::apply([&]<typename... Models>(const Models&...) {
+        return ((Models::name == name and (f.template operator()<Models>(), true)) or ...);
+    }, Zoo{});
+}
+
+void model_zoo(bench::Suite& suite)
+{
+    std::apply([&]<typename... Models>(const Models&...) { (chart<Models>(suite), ...); }, Zoo{});
+}
+
+// Scaling curves of the models, printed, and returned as JSON.
+template <typename... Models>
+std::string scale(size_t max_instances, size_t steps)
+{
+    std::vector<std::string> curves;
+    auto scale_one = [&]<typename M>() {
+        const auto curve = bench::scaling<M>(max_instances, steps);
+        std::clog << bench::scaling_table(M::name, curve);
+        curves.push_back(bench::scaling_json(M::name, curve));
+    };
+    (scale_one.template operator()<Models>(), ...);
+
+    std::string out = std::format("{{\n  \"steps_per_instance\": {},\n  \"scaling\": [\n", steps);
+    for (size_t k = 0; k < curves.size(); ++k)
+        out += curves[k] + (k + 1 < curves.size() ? ",\n" : "\n");
+    return out + "  ]\n}\n";
+}
+
+int main(int argc, char** argv)
+{
+    bench::Suite::Settings settings;
+    const char* json = nullptr;
+    const char* previous = nullptr;
+    std::optional<std::string> latency;
+    std::optional<size_t> scaling;
+    size_t steps = 1 << 18;
+    bool serving = false;
+    bench::ServingSettings load;
+    std::string model = "3-gram<2^12>";
+    for (int k = 1; k < argc; k += 2) {
+        if (k + 1 == argc) {
+            std::cerr << "Missing value for option " << argv[k] << '\n';
+            return 1;
+        }
+        if (not std::strcmp(argv[k], "--filter"))
+            settings.filter = argv[k + 1];
+        else if (not std::strcmp(argv[k], "--repetitions"))
+            settings.repetitions = std::max(1, std::atoi(argv[k + 1]));
+        else if (not std::strcmp(argv[k], "--json"))
+            json = argv[k + 1];
+        else if (not std::strcmp(argv[k], "--compare"))
+            previous = argv[k + 1];
+        else if (not std::strcmp(argv[k], "--latency"))
+            latency = argv[k + 1];
+        else if (not std::strcmp(argv[k], "--scaling"))
+            scaling = (size_t)std::atoi(argv[k + 1]);
+        else if (not std::strcmp(argv[k], "--steps"))
+            steps = (size_t)std::max(1, std::atoi(argv[k + 1]));
+        else if (not std::strcmp(argv[k], "--serving"))
+            load.sessions = (size_t)std::max(1, std::atoi(argv[k + 1])), serving = true;
+        else if (not std::strcmp(argv[k], "--model"))
+            model = argv[k + 1];
+        else if (not std::strcmp(argv[k], "--rate"))
+            load.rate = std::max(1.0, std::atof(argv[k + 1]));
+        else if (not std::strcmp(argv[k], "--arrivals"))
+            load.poisson = std::strcmp(argv[k + 1], "fixed") != 0;
+        else if (not std::strcmp(argv[k], "--workers"))
+            load.workers = (size_t)std::max(1, std::atoi(argv[k + 1]));
+        else if (not std::strcmp(argv[k], "--duration"))
+            load.duration = std::chrono::milliseconds(std::max(1, std::atoi(argv[k + 1])));
+        else {
+            std::cerr << "Unknown option " << argv[k] << '\n';
+            return 1;
+        }
+    }
+    settings.min_repetitions = std::min(settings.min_repetitions, settings.repetitions);
+
+    if (serving) {
+        const bool known = with_model(model, [&]<typename M>() {
+            const bench::ServingReport report = bench::serve<M>(load);
+            std::clog << bench::serving_table(M::name, load, report);
+            if (json)
+                std::ofstream(json) << bench::serving_json(M::name, load, report);
+        });
+        if (not known)
+            std::cerr << "Unknown model " << model << '\n';
+        return known ? 0 : 1;
+    }
+    if (scaling) {
+        const size_t cores = *scaling ? *scaling : std::max(1u, std::thread::hardware_concurrency());
+        const std::string curves = scale<bench::CounterModel, bench::NGramModel<3, 16>,
+            bench::SyntheticModel<64, 1000, 0>, bench::SyntheticModel<65536, 0, 0>>(cores, steps);
+        if (json)
+            std::ofstream(json) << curves;
+        return 0;
+    }
+
+    bench::Suite suite(settings);
+    if (latency) {
+        if (not with_model(*latency, [&]<typename M>() { bench::step_latency<M>(suite, M::name); })) {
+            std::cerr << "Unknown model " << *latency << '\n';
+            return 1;
+        }
+    }
+    else {
+        primitives(suite);
+        harness_overhead(suite);
+        model_zoo(suite);
+    }
+
+    if (previous)
+        std::clog << suite.compare(previous);
+    if (json)
+        std::ofstream(json) << suite.json();
+    return 0;
+}
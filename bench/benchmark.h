@@ -0,0 +1,262 @@
+/*
+* Copyright 2024 Matej Sprogar <matej.sprogar@gmail.com>
+*
+* This file is part of AGITB - Artificial General Intelligence TestBed.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+* */
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <format>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <fstream>
+#include <sstream>
+#include <regex>
+#include <map>
+
+namespace sprogar {
+namespace AGI {
+namespace bench {
+
+    inline const void* volatile kept = nullptr;
+
+    // Keeps the compiler from optimizing away the computation of a value.
+    template <typename T>
+    void keep(T&& value)
+    {
+        kept = std::addressof(value);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    // Two-sided 95% quantile of Student's t distribution with the given degrees of freedom.
+    inline double student_t95(size_t degrees_of_freedom)
+    {
+        static constexpr double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060,
+            2.056, 2.052, 2.048, 2.045, 2.042 };
+        if (degrees_of_freedom == 0)
+            return INFINITY;
+        return degrees_of_freedom <= std::size(table) ? table[degrees_of_freedom - 1] : 1.960;
+    }
+
+    // Timing of one benchmark in nanoseconds per call.
+    struct Result
+    {
+        std::string name;
+        size_t batch = 0, repetitions = 0;          // calls per timed batch, timed batches
+        double mean = 0.0, median = 0.0, min = 0.0;
+        double ci95 = 0.0;                          // half-width of the 95% confidence interval of the mean
+        std::optional<size_t> bytes;                // memory of the benchmarked object, where measured
+        size_t outliers = 0;                        // batches left out of the statistics
+
+        // Summarizes the per-call times of the timed batches. Trimming leaves out the batches beyond the outer
+        // Tukey fences, three interquartile ranges outside the quartiles, which tell of interruptions by the
+        // system rather than of the code.
+        static Result of(std::string name, size_t batch, std::vector<double> times, bool trim = false)
+        {
+            Result r{ .name = std::move(name), .batch = batch, .repetitions = times.size(), .bytes = {}, .outliers = 0 };
+            if (times.empty())
+                return r;
+            std::ranges::sort(times);
+            if (trim and times.size() >= 8) {
+                const double q1 = times[times.size() / 4], q3 = times[3 * times.size() / 4];
+                const auto first = std::ranges::lower_bound(times, q1 - 3 * (q3 - q1));
+                const auto last = std::ranges::upper_bound(times, q3 + 3 * (q3 - q1));
+                r.outliers = times.size() - (last - first);
+                times = std::vector<double>(first, last);
+                r.repetitions = times.size();
+            }
+            const size_t n = times.size();
+            r.mean = std::accumulate(times.begin(), times.end(), 0.0) / n;
+            r.median = n % 2 == 1 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+            r.min = times.front();
+            if (n > 1) {
+                double squares = 0.0;
+                for (double t : times)
+                    squares += (t - r.mean) * (t - r.mean);
+                r.ci95 = student_t95(n - 1) * std::sqrt(squares / (n - 1) / n);
+            }
+            return r;
+        }
+    };
+
+    // Times calls of functions in batches long enough for the clock, after a warm-up that also calibrates the
+    // batch size. Slow functions get fewer repetitions, but never fewer than min_repetitions.
+    class Suite
+    {
+    public:
+        struct Settings
+        {
+            std::chrono::milliseconds warm_up{ 100 };       // per benchmark
+            std::chrono::milliseconds batch_time{ 5 };      // targeted duration of a timed batch
+            std::chrono::milliseconds time_limit{ 3000 };   // per benchmark, once min_repetitions are done
+            size_t repetitions = 30, min_repetitions = 5;
+            std::string filter;                             // runs only the benchmarks whose names contain it
+        };
+
+        Suite() = default;
+        explicit Suite(Settings settings) : settings(std::move(settings)) {}
+
+        // Whether the filter lets the benchmark of the given name run.
+        bool selects(const std::string& name) const { return name.contains(settings.filter); }
+
+        // Times f(), one call of the benchmarked operation, on an object of the given size if it matters.
+        template <typename Func>
+        void measure(std::string name, Func&& f, std::optional<size_t> bytes = {})
+        {
+            if (not selects(name))
+                return;
+            using clock = std::chrono::steady_clock;
+
+            size_t calls = 0;
+            const auto warm_up_start = clock::now();
+            do {
+                f();
+                ++calls;
+            } while (clock::now() - warm_up_start < settings.warm_up);
+            const clock::duration per_call = (clock::now() - warm_up_start) / static_cast<clock::rep>(calls);
+            const size_t batch = std::max<size_t>(1, settings.batch_time / std::max(per_call, clock::duration{ 1 }));
+
+            std::vector<double> times;
+            const auto start = clock::now();
+            while (times.size() < settings.repetitions
+                and (times.size() < settings.min_repetitions or clock::now() - start < settings.time_limit)) {
+                const auto batch_start = clock::now();
+                for (size_t i = 0; i < batch; ++i)
+                    f();
+                const std::chrono::duration<double, std::nano> elapsed = clock::now() - batch_start;
+                times.push_back(elapsed.count() / batch);
+            }
+
+            Result r = Result::of(std::move(name), batch, std::move(times));
+            r.bytes = bytes;
+            record(std::move(r));
+        }
+        // Times batches of `batch` calls of f(copy), each on a copy of `object` made before the clock starts, so
+        // that every batch finds the object as given rather than as the previous batches left it. The batch size
+        // is fixed, as it bounds how far the calls of a batch drift from the given object, and outliers are
+        // trimmed, as the batches are often too short to average out interruptions.
+        template <typename T, typename Func>
+        void measure_on(std::string name, const T& object, Func&& f, size_t batch)
+        {
+            if (not selects(name))
+                return;
+            using clock = std::chrono::steady_clock;
+
+            const auto warm_up_start = clock::now();
+            do {
+                T copy = object;
+                for (size_t i = 0; i < batch; ++i)
+                    f(copy);
+            } while (clock::now() - warm_up_start < settings.warm_up);
+
+            std::vector<double> times;
+            const auto start = clock::now();
+            while (times.size() < settings.repetitions
+                and (times.size() < settings.min_repetitions or clock::now() - start < settings.time_limit)) {
+                T copy = object;
+                const auto batch_start = clock::now();
+                for (size_t i = 0; i < batch; ++i)
+                    f(copy);
+                const std::chrono::duration<double, std::nano> elapsed = clock::now() - batch_start;
+                times.push_back(elapsed.count() / batch);
+            }
+            record(Result::of(std::move(name), batch, std::move(times), true));
+        }
+
+        const std::vector<Result>& report() const { return results; }
+
+        // Compares the results with those of an earlier run saved by json(). A mean counts as changed only where
+        // the 95% confidence intervals of the two runs do not overlap. Results the earlier run lacks are marked new,
+        // and those whose earlier mean was not positive incomparable.
+        std::string compare(const std::string& previous_json) const
+        {
+            std::ifstream file(previous_json);
+            if (not file)
+                return std::format("\nNo previous results in {}\n", previous_json);
+
+            static const std::regex entry(R"re("name": "((?:[^"\\]|\\.)*)".*"mean": ([-+.0-9eE]+).*"ci95": ([-+.0-9eE]+))re");
+            std::map<std::string, std::pair<double, double>> previous;        // name -> (mean, ci95)
+            for (std::string line; std::getline(file, line); )
+                if (std::smatch m; std::regex_search(line, m, entry))
+                    previous[std::regex_replace(m[1].str(), std::regex(R"(\\(.))"), "$1")] = { std::stod(m[2]), std::stod(m[3]) };
+
+            std::string table = std::format("\nCompared with {}:\n{:<48}{:>14}{:>14}{:>10}\n", previous_json, "", "before (ns)", "after (ns)", "change");
+            for (const Result& r : results) {
+                const auto before = previous.find(r.name);
+                if (before == previous.end()) {
+                    table += std::format("{:<48}{:>14}{:>14.1f}{:>10}  new\n", r.name, "", r.mean, "");
+                    continue;
+                }
+                const auto [mean, ci95] = before->second;
+                if (not (mean > 0)) {                                       // no relative change to tell
+                    table += std::format("{:<48}{:>14.1f}{:>14.1f}{:>10}  incomparable\n", r.name, mean, r.mean, "");
+                    continue;
+                }
+                const bool changed = std::abs(r.mean - mean) > r.ci95 + ci95;
+                table += std::format("{:<48}{:>14.1f}{:>14.1f}{:>+9.1f}%  {}\n", r.name, mean, r.mean, 100 * (r.mean - mean) / mean,
+                    not changed ? "" : r.mean < mean ? "faster" : "slower");
+            }
+            return table;
+        }
+
+        std::string json() const
+        {
+            std::string out = "{\n  \"unit\": \"ns\",\n  \"benchmarks\": [";
+            for (size_t k = 0; k < results.size(); ++k) {
+                const Result& r = results[k];
+                out += std::format("{}\n    {{ \"name\": \"{}\", \"batch\": {}, \"repetitions\": {}, \"mean\": {:.3f}, "
+                    "\"median\": {:.3f}, \"min\": {:.3f}, \"ci95\": {:.3f}, \"outliers\": {}{} }}",
+                    k ? "," : "", escaped(r.name), r.batch, r.repetitions, r.mean, r.median, r.min, r.ci95, r.outliers,
+                    r.bytes ? std::format(", \"bytes\": {}", *r.bytes) : "");
+            }
+            return out + "\n  ]\n}\n";
+        }
+
+    private:
+        Settings settings;
+        std::vector<Result> results;
+
+        void record(Result r)
+        {
+            std::clog << std::format("{:<48}{:>14.1f} ns +- {:<10.1f} (median {:.1f}, {} x {} calls){}{}\n",
+                r.name, r.mean, r.ci95, r.median, r.repetitions, r.batch,
+                r.outliers ? std::format(", {} outliers", r.outliers) : "", r.bytes ? std::format(", {} bytes", *r.bytes) : "");
+            results.push_back(std::move(r));
+        }
+
+        static std::string escaped(const std::string& text)
+        {
+            std::string out;
+            for (char c : text) {
+                if (c == '"' or c == '\\')
+                    out += '\\';
+                out += c;
+            }
+            return out;
+        }
+    };
+
+}   // bench
+}   // AGI
+}   // sprogar
@@ -0,0 +1,64 @@
+/*
+* Copyright 2024 Matej Sprogar <matej.sprogar@gmail.com>
+*
+* This file is part of AGITB - Artificial General Intelligence TestBed.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+* */
+#pragma once
+
+#include <string>
+#include <vector>
+#include <format>
+
+#include "../include/agitb.h"
+#include "benchmark.h"
+
+namespace sprogar {
+namespace AGI {
+namespace bench {
+
+    // Times single steps of model M at several ages: fresh, and after the given numbers of random inputs, as the
+    // cost of a step often grows with what the model has learned. Each age is timed on copies of the same aged
+    // model, in batches of 64 steps over the same inputs, so that the timed steps stay close to the given age
+    // and the batches are alike. Include this header in a program of your own to time your model:
+    //
+    //     bench::Suite suite;
+    //     bench::step_latency<MyModel>(suite, "MyModel");
+    //     std::clog << suite.compare("before.json");
+    //     std::ofstream("after.json") << suite.json();
+    template <typename M>
+    void step_latency(Suite& suite, const std::string& name,
+        const std::vector<size_t>& ages = { 0, 1'000, 100'000, 1'000'000 }, unsigned seed = 1)
+    {
+        using Input = std::bitset<BitsPerInput>;
+        using InputSequence = utils::InputSequence<Input>;
+        using Model = utils::Model<M, Input, SimulatedInfinity>;
+        static constexpr size_t StepsPerBatch = 64;
+
+        for (size_t age : ages) {
+            utils::rng.seed(utils::rng_seed = seed);
+            Model aged;
+            aged << InputSequence::lazy(InputSequence::random, (time_t)age);
+            const InputSequence inputs(InputSequence::random, (time_t)StepsPerBatch);
+
+            size_t k = 0;
+            suite.measure_on(std::format("{}: step at age {}", name, age), aged,
+                [&](Model& model) { keep(model(inputs[k++ % StepsPerBatch])); }, StepsPerBatch);
+        }
+    }
+
+}   // bench
+}   // AGI
+}   // sprogar
@@ -0,0 +1,156 @@
+/*
+* Copyright 2024 Matej Sprogar <matej.sprogar@gmail.com>
+*
+* This file is part of AGITB - Artificial General Intelligence TestBed.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+* */
+#pragma once
+
+#include <bitset>
+#include <array>
+#include <vector>
+#include <string>
+#include <format>
+#include <cstdint>
+
+#include "../include/agitb.h"
+
+// Reference models with known costs, for measuring the testbed rather than the models.
+namespace sprogar {
+namespace AGI {
+namespace bench {
+
+    using Input = std::bitset<BitsPerInput>;
+
+    // Predicts nothing at no cost, so that all measured time is spent by the testbed.
+    class NullModel
+    {
+    public:
+        static constexpr const char* name = "null";
+
+        bool operator==(const NullModel&) const = default;
+        Input operator()(const Input&) { return Input(); }
+    };
+
+    // Predicts the number of inputs seen so far: two bytes of state and a constant step cost.
+    class CounterModel
+    {
+    public:
+        static constexpr const char* name = "counter";
+        static constexpr bool byte_comparable = true;
+
+        bool operator==(const CounterModel&) const = default;
+        Input operator()(const Input&) { return Input(++count); }
+
+    private:
+        unsigned short count = 0;
+    };
+
+    // Folds the whole input history into a 64-bit hash and predicts from it, so that no two histories share
+    // a state: a small byte-comparable state that never revisits itself.
+    class HashedHistoryModel
+    {
+    public:
+        static constexpr const char* name = "hashed-history";
+        static constexpr bool byte_comparable = true;
+
+        bool operator==(const HashedHistoryModel&) const = default;
+        Input operator()(const Input& p)
+        {
+            history = (history ^ p.to_ullong()) * 1099511628211ull;
+            return Input(history >> 32);
+        }
+
+    private:
+        std::uint64_t history = 14695981039346656037ull;
+    };
+
+    // Predicts the input that last followed the current context of N - 1 inputs, kept in a hashed table of
+    // 2^TableBits entries: a learner whose state and copy cost grow with the table.
+    template <size_t N = 3, size_t TableBits = 12>
+        requires (N > 1)
+    class NGramModel
+    {
+    public:
+        static inline const std::string name = std::format("{}-gram<2^{}>", N, TableBits);
+        static constexpr bool byte_comparable = true;
+
+        bool operator==(const NGramModel&) const = default;
+        Input operator()(const Input& p)
+        {
+            next[slot()] = (unsigned short)p.to_ulong();
+            std::shift_left(context.begin(), context.end(), 1);
+            context.back() = (unsigned short)p.to_ulong();
+            return Input(next[slot()]);
+        }
+
+    private:
+        std::array<unsigned short, N - 1> context{};
+        std::array<unsigned short, 1 << TableBits> next{};
+
+        size_t slot() const
+        {
+            size_t h = 0;
+            for (unsigned short x : context)
+                h = (h << BitsPerInput | x) * 0x9E3779B97F4A7C15ull;
+            return h >> (64 - TableBits);
+        }
+    };
+
+    // A model whose costs are set at will: StateBytes of heap state, StepWork dependent operations per step,
+    // and CopyWork more per copy on top of copying the state.
+    template <size_t StateBytes, size_t StepWork, size_t CopyWork>
+        requires (StateBytes > 0)
+    class SyntheticModel
+    {
+    public:
+        static inline const std::string name = std::format("synthetic<{},{},{}>", StateBytes, StepWork, CopyWork);
+
+        SyntheticModel() = default;
+        SyntheticModel(const SyntheticModel& src) : state(src.state), position(src.position) { work(CopyWork); }
+        SyntheticModel& operator=(const SyntheticModel& src)
+        {
+            state = src.state;
+            position = src.position;
+            work(CopyWork);
+            return *this;
+        }
+
+        bool operator==(const SyntheticModel&) const = default;
+        Input operator()(const Input& p)
+        {
+            std::uint64_t acc = p.to_ullong() + 1;
+            for (size_t i = 0; i < StepWork; ++i)
+                acc = acc * 6364136223846793005ull + state[(position + i) % StateBytes];
+            state[position] ^= (unsigned char)acc;
+            position = (position + 1) % StateBytes;
+            return Input(acc >> 32);
+        }
+
+    private:
+        std::vector<unsigned char> state = std::vector<unsigned char>(StateBytes);
+        size_t position = 0;
+
+        void work(size_t operations) const
+        {
+            volatile std::uint64_t acc = 0;
+            for (size_t i = 0; i < operations; ++i)
+                acc = acc + i;
+        }
+    };
+
+}   // bench
+}   // AGI
+}   // sprogar
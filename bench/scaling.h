@@ -0,0 +1,165 @@
+/*
+* Copyright 2024 Matej Sprogar <matej.sprogar@gmail.com>
+*
+* This file is part of AGITB - Artificial General Intelligence TestBed.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+* */
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <format>
+#include <chrono>
+#include <thread>
+#include <latch>
+#include <atomic>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../include/agitb.h"
+
+namespace sprogar {
+namespace AGI {
+namespace bench {
+
+    // Pins the calling thread to the given core; returns false where the platform does not allow it.
+    inline bool pin_to_core(size_t core)
+    {
+#ifdef __linux__
+        cpu_set_t cores;
+        CPU_ZERO(&cores);
+        CPU_SET(core % CPU_SETSIZE, &cores);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores) == 0;
+#else
+        return false;
+#endif
+    }
+
+    // Step latency of one instance in nanoseconds.
+    struct InstanceLatency
+    {
+        double p50 = 0.0, p95 = 0.0;
+    };
+
+    // Throughput and step latency of a number of independent model instances stepping at the same time. The
+    // latency is summarized per instance, as pooling the instances would hide one that the others slow down.
+    struct ScalingPoint
+    {
+        size_t instances = 0;
+        double steps_per_second = 0.0;      // of all instances together
+        double efficiency = 0.0;            // relative to as many times the throughput of a single instance
+        std::vector<InstanceLatency> latency;
+        InstanceLatency worst;              // of the instance with the highest p95
+        bool pinned = false;                // every instance ran on a core of its own
+    };
+
+    // Runs 1 to max_instances independent models, each on a thread pinned to a core of its own and fed `steps`
+    // inputs drawn in advance from its own seeded random stream. The models share nothing but what the model
+    // type and the testbed share behind the scenes, so any efficiency lost on the way to max_instances
+    // measures that hidden sharing: global caches, allocator locks, memory bandwidth.
+    template <typename M>
+    std::vector<ScalingPoint> scaling(size_t max_instances, size_t steps, unsigned seed = 1)
+    {
+        using Input = std::bitset<BitsPerInput>;
+        using Model = utils::Model<M, Input, SimulatedInfinity>;
+        using clock = std::chrono::steady_clock;
+        static constexpr size_t StepsPerSample = 32;        // timed together, as single steps are too short for the clock
+
+        std::vector<ScalingPoint> curve;
+        for (size_t n = 1; n <= max_instances; ++n) {
+            std::vector<std::vector<double>> latencies(n);
+            std::vector<clock::time_point> starts(n), ends(n);
+            std::atomic<bool> pinned = true;
+            std::latch ready(n);
+
+            auto instance = [&](size_t i) {
+                if (not pin_to_core(i))
+                    pinned = false;
+                utils::rng.seed(utils::rng_seed = seed + (unsigned)i);
+                const utils::InputSequence<Input> inputs(utils::InputSequence<Input>::random, std::max<size_t>(steps, StepsPerSample));
+                Model model;
+                for (size_t k = 0; k < std::min<size_t>(inputs.size(), 1000); ++k)     // warm-up
+                    model << inputs[k];
+                latencies[i].reserve(inputs.size() / StepsPerSample);
+
+                ready.arrive_and_wait();
+                starts[i] = clock::now();
+                for (size_t k = 0; k + StepsPerSample <= inputs.size(); k += StepsPerSample) {
+                    const auto sample_start = clock::now();
+                    for (size_t s = k; s < k + StepsPerSample; ++s)
+                        model << inputs[s];
+                    const std::chrono::duration<double, std::nano> elapsed = clock::now() - sample_start;
+                    latencies[i].push_back(elapsed.count() / StepsPerSample);
+                }
+                ends[i] = clock::now();
+            };
+            {
+                std::vector<std::jthread> threads;
+                for (size_t i = 0; i < n; ++i)
+                    threads.emplace_back(instance, i);
+            }
+
+            size_t samples = 0;
+            ScalingPoint point;
+            for (std::vector<double>& l : latencies) {
+                samples += l.size();
+                const auto [p50, p95] = utils::percentiles(l);
+                point.latency.push_back({ p50, p95 });
+            }
+            const std::chrono::duration<double> wall = std::ranges::max(ends) - std::ranges::min(starts);
+
+            point.instances = n;
+            point.steps_per_second = samples * StepsPerSample / wall.count();
+            point.efficiency = point.steps_per_second / (n * (curve.empty() ? point.steps_per_second : curve.front().steps_per_second));
+            point.worst = std::ranges::max(point.latency, {}, &InstanceLatency::p95);
+            point.pinned = pinned;
+            curve.push_back(point);
+        }
+        return curve;
+    }
+
+    inline std::string scaling_table(const std::string& model, const std::vector<ScalingPoint>& curve)
+    {
+        std::string table = std::format("\nScaling of {}, step latency of the slowest instance:\n{:>10}{:>16}{:>12}{:>12}{:>12}\n",
+            model, "Instances", "Steps/s", "Efficiency", "p50 (ns)", "p95 (ns)");
+        for (const ScalingPoint& p : curve)
+            table += std::format("{:>10}{:>16.0f}{:>11.0f}%{:>12.1f}{:>12.1f}{}\n",
+                p.instances, p.steps_per_second, 100 * p.efficiency, p.worst.p50, p.worst.p95, p.pinned ? "" : "  (not pinned)");
+        return table;
+    }
+
+    inline std::string scaling_json(const std::string& model, const std::vector<ScalingPoint>& curve)
+    {
+        std::string out = std::format("    {{ \"model\": \"{}\", \"curve\": [", model);
+        for (size_t k = 0; k < curve.size(); ++k) {
+            const ScalingPoint& p = curve[k];
+            std::string per_instance;
+            for (size_t i = 0; i < p.latency.size(); ++i)
+                per_instance += std::format("{}{{ \"p50\": {:.3f}, \"p95\": {:.3f} }}", i ? ", " : "", p.latency[i].p50, p.latency[i].p95);
+            out += std::format("{}\n      {{ \"instances\": {}, \"steps_per_second\": {:.1f}, \"efficiency\": {:.4f}, "
+                "\"worst\": {{ \"p50\": {:.3f}, \"p95\": {:.3f} }}, \"latency\": [ {} ], \"pinned\": {} }}",
+                k ? "," : "", p.instances, p.steps_per_second, p.efficiency, p.worst.p50, p.worst.p95, per_instance, p.pinned);
+        }
+        return out + " ] }";
+    }
+
+}   // bench
+}   // AGI
+}   // sprogar
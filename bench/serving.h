@@ -0,0 +1,162 @@
+/*
+* Copyright 2024 Matej Sprogar <matej.sprogar@gmail.com>
+*
+* This file is part of AGITB - Artificial General Intelligence TestBed.
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+* */
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <format>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <memory>
+
+#include "../include/agitb.h"
+
+namespace sprogar {
+namespace AGI {
+namespace bench {
+
+    // Open-loop load on many model sessions: inputs arrive at each session at their own times, whether or not
+    // the sessions keep up.
+    struct ServingSettings
+    {
+        size_t sessions = 1000;
+        double rate = 100'000;                              // inputs per second, over all sessions
+        bool poisson = true;                                // exponential inter-arrival times, or else a fixed period
+        size_t workers = std::thread::hardware_concurrency();
+        std::chrono::milliseconds duration{ 2000 };
+        unsigned seed = 1;
+    };
+
+    struct ServingReport
+    {
+        double offered_rate = 0.0, achieved_rate = 0.0;     // inputs per second
+        double p50 = 0.0, p99 = 0.0, p999 = 0.0, max = 0.0; // latency in microseconds from the scheduled arrival
+        double service_p50 = 0.0, service_p99 = 0.0;        // latency in microseconds from the start of the step
+        double late = 0.0;                                  // fraction of inputs stepped more than 1 ms after arrival
+    };
+
+    // The q-quantile of sorted values.
+    inline double quantile(const std::vector<double>& sorted, double q)
+    {
+        return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, (size_t)(q * sorted.size()))];
+    }
+
+    // Simulates serving `sessions` instances of model M from a pool of workers. The arrivals of all sessions are
+    // scheduled in advance and taken by the workers in the order of their scheduled times; a session steps
+    // through its own inputs in order, one at a time. The latency of a step is measured from its scheduled
+    // arrival rather than from when a worker got round to it, which corrects for coordinated omission: a
+    // stalled step delays the steps queued behind it, and their latencies say so, instead of the stall
+    // postponing the arrivals as a closed-loop client would.
+    template <typename M>
+    ServingReport serve(const ServingSettings& settings)
+    {
+        using Input = std::bitset<BitsPerInput>;
+        using Model = utils::Model<M, Input, SimulatedInfinity>;
+        using clock = std::chrono::steady_clock;
+        using std::chrono::duration;
+
+        struct Arrival { double time; size_t session, sequence; Input input; };       // time in seconds from the start
+        struct Session { Model model; std::atomic<size_t> served = 0; };
+
+        // the schedule
+        std::mt19937 rng(settings.seed);
+        std::vector<Arrival> arrivals;
+        const double session_rate = settings.rate / settings.sessions;
+        const double horizon = duration<double>(settings.duration).count();
+        std::exponential_distribution<double> gap(session_rate);
+        for (size_t s = 0; s < settings.sessions; ++s) {
+            double t = settings.poisson ? gap(rng) : std::uniform_real_distribution<double>(0, 1 / session_rate)(rng);
+            for (size_t sequence = 0; t < horizon; ++sequence, t += settings.poisson ? gap(rng) : 1 / session_rate)
+                arrivals.push_back({ t, s, sequence, Input(rng()) });
+        }
+        std::ranges::sort(arrivals, {}, &Arrival::time);
+
+        const std::unique_ptr<Session[]> sessions = std::make_unique<Session[]>(settings.sessions);
+        std::vector<double> latency(arrivals.size()), service(arrivals.size());
+        std::atomic<size_t> next = 0;
+
+        const clock::time_point start = clock::now() + std::chrono::milliseconds(10);
+        auto worker = [&]() {
+            for (size_t k; (k = next++) < arrivals.size(); ) {
+                const Arrival& a = arrivals[k];
+                const auto scheduled = start + std::chrono::duration_cast<clock::duration>(duration<double>(a.time));
+                if (scheduled - clock::now() > std::chrono::microseconds(200))
+                    std::this_thread::sleep_until(scheduled - std::chrono::microseconds(100));
+                while (clock::now() < scheduled)
+                    ;
+
+                Session& session = sessions[a.session];
+                while (session.served.load(std::memory_order_acquire) != a.sequence)     // its predecessor is being served
+                    std::this_thread::yield();
+                const auto step_start = clock::now();
+                session.model << a.input;
+                const auto done = clock::now();
+                session.served.store(a.sequence + 1, std::memory_order_release);
+
+                latency[k] = duration<double, std::micro>(done - scheduled).count();
+                service[k] = duration<double, std::micro>(done - step_start).count();
+            }
+        };
+        {
+            std::vector<std::jthread> pool(std::max<size_t>(settings.workers, 1) - 1);
+            for (std::jthread& thread : pool)
+                thread = std::jthread(worker);
+            worker();
+        }
+        const double elapsed = duration<double>(clock::now() - start).count();
+
+        ServingReport report;
+        report.offered_rate = arrivals.size() / horizon;
+        report.achieved_rate = arrivals.size() / std::max(elapsed, horizon);
+        report.late = (double)std::ranges::count_if(latency, [&](double us) { return us > 1000; }) / std::max<size_t>(arrivals.size(), 1);
+        std::ranges::sort(latency);
+        std::ranges::sort(service);
+        report.p50 = quantile(latency, 0.5), report.p99 = quantile(latency, 0.99), report.p999 = quantile(latency, 0.999);
+        report.max = latency.empty() ? 0.0 : latency.back();
+        report.service_p50 = quantile(service, 0.5), report.service_p99 = quantile(service, 0.99);
+        return report;
+    }
+
+    inline std::string serving_table(const std::string& model, const ServingSettings& settings, const ServingReport& r)
+    {
+        return std::format("\nServing {} sessions of {} with {} workers, {} arrivals:\n"
+            "  offered {:.0f} inputs/s, achieved {:.0f} inputs/s\n"
+            "  latency (us):  p50 {:.1f}  p99 {:.1f}  p99.9 {:.1f}  max {:.1f}  ({:.2f}% late by over 1 ms)\n"
+            "  service (us):  p50 {:.1f}  p99 {:.1f}\n",
+            settings.sessions, model, settings.workers, settings.poisson ? "Poisson" : "fixed-rate",
+            r.offered_rate, r.achieved_rate, r.p50, r.p99, r.p999, r.max, 100 * r.late, r.service_p50, r.service_p99);
+    }
+
+    inline std::string serving_json(const std::string& model, const ServingSettings& settings, const ServingReport& r)
+    {
+        return std::format("{{\n  \"model\": \"{}\", \"sessions\": {}, \"workers\": {}, \"arrivals\": \"{}\",\n"
+            "  \"offered_rate\": {:.1f}, \"achieved_rate\": {:.1f},\n"
+            "  \"latency_us\": {{ \"p50\": {:.3f}, \"p99\": {:.3f}, \"p999\": {:.3f}, \"max\": {:.3f} }}, \"late\": {:.6f},\n"
+            "  \"service_us\": {{ \"p50\": {:.3f}, \"p99\": {:.3f} }}\n}}\n",
+            model, settings.sessions, settings.workers, settings.poisson ? "poisson" : "fixed",
+            r.offered_rate, r.achieved_rate, r.p50, r.p99, r.p999, r.max, r.late, r.service_p50, r.service_p99);
+    }
+
+}   // bench
+}   // AGI
+}   // sprogar
@@ -23,6 +23,18 @@
 #include <bitset>
 #include <algorithm>
 #include <chrono>
+#include <fstream>
+#include <optional>
+#include <mutex>
+#include <array>
+#include <memory>
+#include <typeinfo>
+#include <map>
+#include <sstream>
+#include <cstdlib>
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
 
 #include "utils.h"
 
@@ -38,7 +50,17 @@ const time_t SequenceLength = 7;        // N
 static_assert(SequenceLength > 1);
 static_assert(BitsPerInput > 1);
 
+// AGITB settings : largest set of inputs a test sweeps through; larger input spaces are sampled with coverage guarantees
+const size_t MaxInputsPerSweep = 1 << 10;
 
+// AGITB settings : most cases an exhaustive run covers; a test with more cases is sampled as in a plain run
+const size_t MaxExhaustiveCases = size_t{ 1 } << 20;
+
+
+
+template <typename... Systems>
+    requires (sizeof...(Systems) > 0)
+class Tournament;
 
 // Artificial General Intelligence TestBed
 template <typename SystemUnderEvaluation>
@@ -49,29 +71,216 @@ class TestBed
     using InputSequence = utils::InputSequence<Input>;
     using Model = utils::Model<SystemUnderEvaluation, Input, SimulatedInfinity>;
 
+    template <typename... Systems>
+        requires (sizeof...(Systems) > 0)
+    friend class Tournament;
+
     enum test_repetitions { RepeatOnce = 1, Repeat10x = 10, Repeat100x = 100, RepeatForever = SimulatedInfinity };
+    static const unsigned RealTimeLiveness = 12;
+    static constexpr std::array<unsigned, 3> StatisticalTests = { 8, 9, 10 };
+    static constexpr double AcceptableFailureRate = 1.0 / SimulatedInfinity, UnacceptableFailureRate = 0.05;
+    static constexpr std::array<unsigned, 2> UnmemoizedTests = { 2, RealTimeLiveness };    // they observe the model's own steps
+    static constexpr std::array<unsigned, 2> UngradedTests = { 11, RealTimeLiveness };     // inoperative, and timing-sensitive
+
+    // Peak number of simultaneously live models in a repetition of each test, learnable_random_sequence() included,
+    // and the copies the models keep while they run: the checkpoint of a model that adapts, and the predecessor a
+    // memoized step records.
+    static constexpr std::array<size_t, 12> PeakLiveModels = {
+        2,                          // #1  A, B
+        3,                          // #2  R, A, B
+        SimulatedInfinity + 5,      // #3  trajectory, A, B, C, D, predecessor
+        4,                          // #4  A, _A, _B, predecessor
+        4,                          // #5  A, B, checkpoint, predecessor
+        4,                          // #6  A, and B or the M of learnable_random_sequence(), checkpoint, predecessor
+        3,                          // #7  A, checkpoint, predecessor
+        5,                          // #8  A, B, and the M of learnable_random_sequence(), checkpoint, predecessor
+        4,                          // #9  A, B, checkpoint, predecessor
+        2,                          // #10 fresh, predecessor
+        0,                          // #11
+        1,                          // #12 M
+    };
 
 public:
+    enum interleaved_tag { interleaved = 0 };
+    enum exhaustive_tag { exhaustive = 0 };
+
+    // File that collects the (test number, seed) pair of every failure; an empty path disables it.
+    static inline std::string failure_corpus;
+
+    // Error rate of the opt-in sequential verdict for the statistical tests #8, #9 and #10; 0 disables it.
+    // Instead of failing on the first failed repetition, a sequential probability ratio test weighs the
+    // repetitions of these tests until it can tell a model that fails at most once in SimulatedInfinity
+    // repetitions from one that fails in 5% of them, and then stops.
+    static inline double sequential_error_rate = 0.0;
+
+    // Initial size of the per-repetition memory arena, optionally backed by huge pages; 0 disables the arena.
+    // InputSequence and models built from std::pmr containers allocate from it during serial repetitions.
+    static inline size_t arena_size = 0;
+    static inline bool arena_huge_pages = false;
+
+    // Memory the parallel parts of a run may use, in bytes; 0 leaves it unlimited. Concurrent repetitions are
+    // admitted only as far as their estimated peak memory fits, down to running them one at a time.
+    static inline size_t memory_ceiling = 0;
+
+    // Memory of the opt-in transition cache in bytes; 0 disables it. Models that provide a state hash, or are made
+    // of plain bytes, then replay the transitions they have made before instead of recomputing them. Tests #2
+    // (Determinism) and #12 (Real-time liveness) always step the model itself.
+    static inline size_t transition_cache_size = 0;
+
+    // Memory the transition graph of a finite-state model may take, in bytes, and no more than the memory ceiling.
+    // A model whose graph does not fit is stepped as usual.
+    static inline size_t state_graph_budget = size_t{ 1 } << 30;
+
+    // Opt-in approximate learning: the number of passes over a sequence without improvement of the match score
+    // after which the sequence is deemed unlearnable; 0 disables it and learning takes up to SimulatedInfinity
+    // passes. The results report that the approximation was used and how many timesteps it saved.
+    static inline size_t plateau_patience = 0;
+
+    // Opt-in learning telemetry: histograms of adaptation times, the learning curve over passes, and the number
+    // of sequences learned before saturation in #6a, aggregated over all learning episodes and reported with the results.
+    static inline bool telemetry = false;
+
+    // Parameter points whose outcomes sweep() keeps for later sweeps; beyond them, the points swept longest ago are
+    // forgotten first. 0 keeps nothing between sweeps.
+    static inline size_t sweep_cache_points = 1024;
+
     // Runs all tests from the testbed using the specified test mode.
     static bool run(size_t repetitions_override = 0)
     {
+        return run_tests(repetitions_override, false);
+    }
+    // Runs all tests, but instead of sampling random cases, tests that can enumerate their cases cover each of
+    // them exactly once, partitioned across all cores. The remaining tests run as with run().
+    static bool run(exhaustive_tag, size_t repetitions_override = 0)
+    {
+        return run_tests(repetitions_override, true);
+    }
+    // Runs one case of a test that enumerates its cases, as reported by a failure of run(exhaustive).
+    static bool run(exhaustive_tag, unsigned test_number, size_t exhaustive_case)
+    {
+        const auto* variant = exhaustive_variant(test_number - 1);
+        ASSERT(variant != nullptr and exhaustive_case < std::get<size_t>(*variant));
+
+        std::clog << "Artificial General Intelligence Testbed\nRunning 1 case:\n";
+        reset_run_figures();
+        std::clog << std::get<std::string>(testbed[test_number - 1]) << ", exhaustive case " << exhaustive_case << std::endl;
+        if (const auto failure = replay_case(test_number - 1, exhaustive_case))
+            fail(test_number - 1, *failure, true, exhaustive_case);
+
+        std::clog << green("\nPASS\n") << approximation_report() << telemetry_report();
+        return true;
+    }
+    // Runs all tests within the given wall-clock budget. Repetitions are allocated in proportion to each
+    // test's configured repetitions and its measured cost, and the achieved coverage is reported per test.
+    static bool run(std::chrono::seconds time_budget)
+    {
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + time_budget;
+        auto remaining_us = [&]() { return (double)std::chrono::duration_cast<std::chrono::microseconds>(deadline - clock::now()).count(); };
+
         std::clog << "Artificial General Intelligence Testbed\n";
-                
-        std::clog << "\n\nRunning 12 tests...\n";
+        reset_run_figures();
+        replay_failure_corpus();
+
+        std::clog << "\n\nRunning 12 tests within " << time_budget.count() << " s...\n";
         const std::string go_back(20, '\b');
-        for (const auto& [info, repetitions, test] : testbed) {
+        std::mt19937 seeds(utils::rng());
+
+        // calibration: a single repetition of each test measures its cost
+        std::vector<double> cost_us(testbed.size());
+        std::vector<size_t> done(testbed.size(), 0), limits(testbed.size());
+        auto evidence = sequential_evidence();
+        for (size_t i = 0; i < testbed.size(); ++i) {
+            const auto& [info, repetitions, test] = testbed[i];
             std::clog << info << "  " << std::endl;
 
-            const size_t test_repetitions = repetitions_override == 0 ? repetitions : std::min((size_t)repetitions, (size_t)repetitions_override);
-            for (size_t r = 1; r <= test_repetitions; ++r) {
-                std::clog << r << '/' << test_repetitions << "   " << go_back;
+            bool settled = false;
+            cost_us[i] = std::max(1.0, (double)utils::time_it([&]() { settled = repeat(i, seeds(), evidence[i]); }));
+            done[i] = 1;
+            limits[i] = settled ? (size_t)done[i] : (size_t)repetitions;
+        }
+
+        std::clog << "\nSpending the remaining budget...\n";
+        for (size_t i = 0; i < testbed.size(); ++i) {
+            const auto& [info, repetitions, test] = testbed[i];
 
-                utils::rng_seed = utils::rng();
-                test();
+            // re-plan with the budget that is actually left
+            const size_t planned = plan_repetitions(done, limits, cost_us, remaining_us(), i)[i];
+
+            std::clog << info << "  " << std::endl;
+            double spent_us = 0;
+            for (size_t r = done[i]; done[i] < planned and remaining_us() > 0; ) {
+                std::clog << done[i] + 1 << '/' << planned << "   " << go_back;
+
+                bool settled = false;
+                spent_us += (double)utils::time_it([&]() { settled = repeat(i, seeds(), evidence[i]); });
+                ++done[i];
+                cost_us[i] = std::max(1.0, spent_us / (done[i] - r));
+                if (settled)
+                    limits[i] = done[i];
             }
+            settle(i, evidence[i]);
+        }
+
+        std::clog << "\n\nCoverage:\n";
+        for (size_t i = 0; i < testbed.size(); ++i) {
+            const auto& [info, repetitions, test] = testbed[i];
+            std::clog << std::format("{:<32}{:>6}/{:<6}{:>6.1f}%{}\n", info, done[i], (size_t)repetitions, 100.0 * done[i] / (size_t)repetitions,
+                evidence[i] ? "  (sequential verdict)" : "");
         }
 
-        std::clog << green("\n\nPASS\n");
+        std::clog << green("\n\nPASS\n") << approximation_report() << telemetry_report();
+        return true;
+    }
+    // Runs all tests with their repetitions interleaved in rounds, so that a failure surfaces as early as possible.
+    // Each round runs one repetition of every unfinished test, historically failing tests first and cheaper tests
+    // before more expensive ones. A passing model receives the same repetitions as with run().
+    static bool run(interleaved_tag, size_t repetitions_override = 0)
+    {
+        std::clog << "Artificial General Intelligence Testbed\n";
+        reset_run_figures();
+        replay_failure_corpus();
+
+        std::clog << "\n\nRunning 12 tests, interleaved...\n";
+        const std::string go_back(20, '\b');
+
+        std::vector<size_t> failures(testbed.size(), 0);
+        for (const CorpusEntry& entry : read_failure_corpus())
+            ++failures[entry.test_number - 1];
+
+        std::vector<size_t> todo(testbed.size()), order(testbed.size());
+        std::vector<double> cost_us(testbed.size(), 0.0);
+        size_t rounds = 0;
+        for (size_t i = 0; i < testbed.size(); ++i) {
+            const size_t repetitions = std::get<test_repetitions>(testbed[i]);
+            todo[i] = repetitions_override == 0 ? repetitions : std::min(repetitions, repetitions_override);
+            rounds = std::max(rounds, todo[i]);
+            order[i] = i;
+        }
+
+        std::mt19937 seeds(utils::rng());
+        auto evidence = sequential_evidence();
+        for (size_t round = 1; round <= rounds; ++round) {
+            std::clog << round << '/' << rounds << "   " << go_back;
+
+            std::ranges::stable_sort(order, [&](size_t a, size_t b) {
+                return failures[a] != failures[b] ? failures[a] > failures[b] : cost_us[a] < cost_us[b];
+            });
+            for (size_t i : order) {
+                if (todo[i] == 0)
+                    continue;
+
+                bool settled = false;
+                const double dt = (double)utils::time_it([&]() { settled = repeat(i, seeds(), evidence[i]); });
+
+                cost_us[i] += (dt - cost_us[i]) / round;    // running mean
+                todo[i] = settled ? 0 : todo[i] - 1;
+                if (todo[i] == 0)
+                    settle(i, evidence[i]);
+            }
+        }
+
+        std::clog << green("\n\nPASS\n") << approximation_report() << telemetry_report();
         return true;
     }
     // Runs a specified test from the testbed using the given RNG seed.
@@ -83,19 +292,639 @@ public:
         const auto& [info, repetitions, test] = testbed[test_number-1];
 
         std::clog << "Artificial General Intelligence Testbed\nRunning 1 test:\n";
+        reset_run_figures();
         std::clog << "Random seed: " << rng_seed << std::endl << std::endl;
         std::clog << info << std::endl;
 
         // Run once
+        utils::memoize_transitions = memoizes(test_number - 1);
+        utils::plateau_patience = plateau_patience;
+        utils::record_telemetry = telemetry;
         test();
+        utils::memoize_transitions = false;
+        utils::plateau_patience = 0;
+        utils::record_telemetry = false;
 
-        std::clog << green("\nPASS\n");
+        std::clog << green("\nPASS\n") << approximation_report() << telemetry_report();
         return true;
     }
+
+    // Graded result of a candidate in a population.
+    struct Fitness
+    {
+        std::array<std::optional<double>, 12> pass_rate;        // fraction of passed repetitions per graded test
+        size_t repetitions = 0;                                 // per graded test
+        size_t learned = 0, unlearned = 0;                      // learning episodes
+        double mean_adaptation_time = 0.0;                      // timesteps per learned sequence
+        bool culled = false;                                    // fell behind before the full budget
+
+        // Mean pass rate over the graded tests.
+        double score() const
+        {
+            double sum = 0.0;
+            size_t graded = 0;
+            for (const auto& rate : pass_rate)
+                if (rate)
+                    sum += *rate, ++graded;
+            return graded ? sum / graded : 0.0;
+        }
+    };
+    // Fitness function for architecture search over the parameter points of a Configured model. Instead of stopping
+    // at the first failure, every repetition counts towards a graded score per test. All candidates are run from the
+    // same seeds, which makes the evaluation deterministic and the candidates comparable, and concurrently, as far
+    // as the memory ceiling admits. Successive halving culls the weaker half of the population whenever the budget
+    // per candidate doubles, so that only the best candidates receive all `repetitions` of each test. Tests #11 and
+    // #12 are not graded.
+    template <typename Parameters>
+        requires utils::Parameterised<SystemUnderEvaluation> and std::same_as<Parameters, typename SystemUnderEvaluation::parameters_type>
+    static std::vector<Fitness> evaluate(const std::vector<Parameters>& population, size_t repetitions = 16, unsigned seed = 0)
+    {
+        if (population.empty())
+            return {};
+
+        const auto [seeds, workers] = search_setup(population.front(), repetitions, seed);
+
+        std::vector<Fitness> fitness(population.size());
+        std::vector<std::array<size_t, 12>> passed(population.size());
+        std::vector<double> learning_time(population.size(), 0.0);
+        std::vector<size_t> alive(population.size());
+        std::iota(alive.begin(), alive.end(), 0);
+
+        // the telemetry that grades the candidates is left out of the caller's
+        const bool recording = std::exchange(telemetry, true);
+        const utils::LearningTelemetry own = utils::telemetry();
+        utils::LearningTelemetry total;
+        {
+            std::lock_guard lock(utils::telemetry_mutex);
+            total = utils::telemetry_total;
+        }
+        const size_t rungs = std::min(std::bit_width(population.size()), std::bit_width(seeds.size())) - 1;
+        for (size_t rung = 0; rung <= rungs; ++rung) {
+            const size_t budget = seeds.size() >> (rungs - rung);
+            std::clog << "Evaluating " << alive.size() << " candidates with " << budget << " repetitions per test...\n";
+
+            utils::parallel_for(alive.size(), [&](size_t k) {
+                const size_t c = alive[k];
+                SystemUnderEvaluation::configuration = &population[c];
+                Fitness& f = fitness[c];
+                const utils::LearningTelemetry before = utils::telemetry();
+
+                for (size_t i = 0; i < testbed.size(); ++i) {
+                    if (std::ranges::find(UngradedTests, i + 1) != UngradedTests.end())
+                        continue;
+                    for (size_t r = f.repetitions; r < budget; ++r)
+                        passed[c][i] += not attempt(i, seeds[r]);
+                    f.pass_rate[i] = (double)passed[c][i] / budget;
+                }
+                f.repetitions = budget;
+
+                const utils::LearningTelemetry& after = utils::telemetry();
+                f.learned += after.adaptation_times.count() - before.adaptation_times.count();
+                f.unlearned += after.unlearned - before.unlearned;
+                learning_time[c] += after.adaptation_times.total() - before.adaptation_times.total();
+                f.mean_adaptation_time = f.learned ? learning_time[c] / f.learned : 0.0;
+                SystemUnderEvaluation::configuration = nullptr;
+                return true;
+            }, workers);
+
+            if (rung < rungs) {
+                std::ranges::stable_sort(alive, std::greater<>(), [&](size_t c) { return fitness[c].score(); });
+                for (size_t k = (alive.size() + 1) / 2; k < alive.size(); ++k)
+                    fitness[alive[k]].culled = true;
+                alive.resize((alive.size() + 1) / 2);
+            }
+        }
+        telemetry = recording;
+        utils::telemetry() = own;
+        {
+            std::lock_guard lock(utils::telemetry_mutex);
+            utils::telemetry_total = total;
+        }
+        return fitness;
+    }
+
+    // Runs one repetition of the indexed test (0 for #1) from the given seed and returns the failure message, if any.
+    static std::optional<std::string> attempt(size_t index, unsigned seed)
+    {
+        return try_test(std::get<void(*)()>(testbed[index]), seed, memoizes(index));
+    }
+    // Measured memory of one informed model: the growth of the resident memory over a batch of copies, but no
+    // less than the size of the object itself. The measurement leaves the random generator untouched, is taken
+    // once, on the first call, and reads the memory of the whole process, so no other thread should allocate then.
+    static size_t model_footprint()
+    {
+        static const size_t bytes = []() {
+            const std::mt19937 saved = utils::rng;
+            const Model informed(Model::random);
+            utils::rng = saved;
+
+            const size_t copies = 64;
+            const size_t before = utils::resident_memory();
+            const std::vector<Model> batch(copies, informed);
+            const size_t after = utils::resident_memory();
+            return std::max(sizeof(Model), after > before ? (after - before) / copies : 0);
+        }();
+        return bytes;
+    }
+
+    // Outcome of a parameter point in a sweep.
+    template <typename Parameters>
+    struct SweepResult
+    {
+        Parameters point;
+        std::array<std::optional<size_t>, 12> passed;          // passed repetitions per swept test
+        std::array<std::chrono::microseconds, 12> cost{};       // time spent on all repetitions of each test
+        size_t repetitions = 0;                                 // per swept test
+
+        bool passes_all() const
+        {
+            return std::ranges::all_of(passed, [this](const auto& p) { return not p or *p == repetitions; });
+        }
+    };
+    // Sweeps the parameter points of a Configured model, such as the `utils::grid_points` of a grid search or the
+    // `utils::random_points` of a random search, and prints a table of per-test outcomes and costs. Each point runs
+    // every repetition of every test from the same seeds, with the points spread across the cores as far as the
+    // memory ceiling admits. Outcomes are cached per parameter point, test and seed, so that refining a sweep, or
+    // sweeping overlapping points again, only runs what has not been run before, for up to sweep_cache_points
+    // points and as long as the settings that affect the outcomes stay the same. Tests #11 and #12 are not swept.
+    template <typename Parameters>
+        requires utils::Parameterised<SystemUnderEvaluation> and std::same_as<Parameters, typename SystemUnderEvaluation::parameters_type>
+    static std::vector<SweepResult<Parameters>> sweep(const std::vector<Parameters>& points, size_t repetitions = 10, unsigned seed = 0)
+    {
+        struct Outcome { bool passed; std::chrono::microseconds cost; };
+        using Outcomes = std::map<std::pair<size_t, unsigned>, Outcome>;                 // by (test, seed)
+        static std::vector<std::pair<Parameters, Outcomes>> cache;                       // swept longest ago first
+        static std::pair<size_t, double> cached_settings = { plateau_patience, sequential_error_rate };
+        if (const std::pair settings = { plateau_patience, sequential_error_rate }; std::exchange(cached_settings, settings) != settings)
+            cache.clear();
+
+        std::vector<SweepResult<Parameters>> results(points.size());
+        if (points.empty())
+            return results;
+
+        const auto [seeds, workers] = search_setup(points.front(), repetitions, seed);
+
+        std::vector<size_t> entry(points.size());                       // of each point in the cache
+        std::vector<size_t> distinct;                                   // entries to run, each by one worker only
+        for (size_t k = 0; k < points.size(); ++k) {
+            entry[k] = std::ranges::find(cache, points[k], &std::pair<Parameters, Outcomes>::first) - cache.begin();
+            if (entry[k] == cache.size())
+                cache.emplace_back(points[k], Outcomes{});
+            if (std::ranges::find(distinct, entry[k]) == distinct.end())
+                distinct.push_back(entry[k]);
+        }
+
+        auto swept = [](size_t i) { return std::ranges::find(UngradedTests, i + 1) == UngradedTests.end(); };
+        std::atomic<size_t> fresh = 0;
+        std::clog << "Sweeping " << distinct.size() << " parameter points with " << seeds.size() << " repetitions per test...\n";
+        utils::parallel_for(distinct.size(), [&](size_t d) {
+            auto& [point, outcomes] = cache[distinct[d]];
+            SystemUnderEvaluation::configuration = &point;
+            for (size_t i = 0; i < testbed.size(); ++i)
+                for (unsigned s : seeds)
+                    if (swept(i) and not outcomes.contains({ i, s })) {
+                        const auto start = std::chrono::steady_clock::now();
+                        const bool passed = not attempt(i, s);
+                        outcomes[{ i, s }] = { passed, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) };
+                        ++fresh;
+                    }
+            SystemUnderEvaluation::configuration = nullptr;
+            return true;
+        }, workers);
+
+        for (size_t k = 0; k < points.size(); ++k) {
+            SweepResult<Parameters>& result = results[k];
+            result.point = points[k];
+            result.repetitions = seeds.size();
+            for (size_t i = 0; i < testbed.size(); ++i) {
+                if (not swept(i))
+                    continue;
+                result.passed[i] = 0;
+                for (unsigned s : seeds) {
+                    const Outcome& outcome = cache[entry[k]].second.at({ i, s });
+                    *result.passed[i] += outcome.passed;
+                    result.cost[i] += outcome.cost;
+                }
+            }
+        }
+        std::ranges::stable_partition(cache, [&](const auto& e) { return std::ranges::find(points, e.first) == points.end(); });
+        if (cache.size() > sweep_cache_points)
+            cache.erase(cache.begin(), cache.end() - sweep_cache_points);
+
+        std::clog << sweep_table(results) << fresh << " repetitions run, the rest reused from earlier sweeps.\n";
+        return results;
+    }
             
 private:
-    static inline const auto all_distinct_inputs = std::views::iota(0, 1 << BitsPerInput)
-        | std::views::transform([](int i) { return Input(i); });
+    static bool run_tests(size_t repetitions_override, bool exhaustively)
+    {
+        std::clog << "Artificial General Intelligence Testbed\n";
+        reset_run_figures();
+        replay_failure_corpus();
+                
+        std::clog << "\n\nRunning 12 tests...\n";
+        const std::string go_back(20, '\b');
+        std::mt19937 seeds(utils::rng());
+        auto evidence = sequential_evidence();
+        for (size_t i = 0; i < testbed.size(); ++i) {
+            const auto& [info, repetitions, test] = testbed[i];
+            std::clog << info << "  " << std::endl;
+
+            if (exhaustively and cover(i))
+                continue;
+
+            const size_t test_repetitions = repetitions_override == 0 ? (size_t)repetitions : std::min((size_t)repetitions, (size_t)repetitions_override);
+            for (size_t r = 1; r <= test_repetitions; ++r) {
+                std::clog << r << '/' << test_repetitions << "   " << go_back;
+
+                if (repeat(i, seeds(), evidence[i])) {
+                    std::clog << "sequential verdict after " << r << " repetitions" << std::endl;
+                    break;
+                }
+            }
+            settle(i, evidence[i]);
+        }
+
+        std::clog << green("\n\nPASS\n") << approximation_report() << telemetry_report();
+        return true;
+    }
+    // The exhaustive variant of the indexed test, or nullptr if the test cannot enumerate its cases, or has more
+    // than MaxExhaustiveCases of them.
+    static const std::tuple<unsigned, size_t, void(*)(size_t)>* exhaustive_variant(size_t index)
+    {
+        const auto variant = std::ranges::find_if(exhaustive_variants, [&](const auto& v) { return std::get<0>(v) == index + 1 and std::get<size_t>(v) > 0; });
+        return variant == exhaustive_variants.end() ? nullptr : &*variant;
+    }
+    // Runs one case of the indexed test and returns the failure message, if any.
+    static std::optional<std::string> replay_case(size_t index, size_t exhaustive_case)
+    {
+        const auto test_case = std::get<void(*)(size_t)>(*exhaustive_variant(index));
+        return try_test([&]() { test_case(exhaustive_case); }, (unsigned)exhaustive_case, memoizes(index));
+    }
+    // Runs every case of the indexed test once, in parallel; returns false if the test cannot enumerate its cases.
+    static bool cover(size_t index)
+    {
+        const auto* variant = exhaustive_variant(index);
+        if (variant == nullptr)
+            return false;
+
+        const auto& [test_number, case_count, test_case] = *variant;
+        const bool memoize = memoizes(index);
+        std::mutex mutex;
+        std::optional<std::pair<size_t, std::string>> first_failure;
+        utils::parallel_for(case_count, [&](size_t k) {
+            const auto failure = try_test([&]() { test_case(k); }, (unsigned)k, memoize);
+            if (failure) {
+                std::lock_guard lock(mutex);
+                if (not first_failure)
+                    first_failure.emplace(k, *failure);
+            }
+            return not failure;
+        }, admissible_workers([index]() { return peak_memory(index); }));
+
+        if (first_failure) {
+            const auto& [k, what] = *first_failure;
+            fail(index, what, true, k);
+        }
+        std::clog << case_count << " cases covered" << std::endl;
+        return true;
+    }
+
+    // Extends the planned repetitions of the tests from `first` onwards, up to their limits, within the budget
+    // and given the cost of a repetition of each. Each step tops up the test with the lowest coverage relative
+    // to its configured repetitions, which approximates a proportional split while also spending the budget
+    // that rounding a proportional split would leave unused.
+    static std::vector<size_t> plan_repetitions(std::vector<size_t> planned, const std::vector<size_t>& limits,
+        const std::vector<double>& cost_us, double budget_us, size_t first)
+    {
+        while (true) {
+            size_t next = testbed.size();
+            for (size_t i = first; i < testbed.size(); ++i) {
+                const size_t repetitions = std::get<test_repetitions>(testbed[i]);
+                if (planned[i] >= limits[i] or cost_us[i] > budget_us)
+                    continue;
+                if (next == testbed.size() or planned[i] * std::get<test_repetitions>(testbed[next]) < planned[next] * repetitions)
+                    next = i;
+            }
+            if (next == testbed.size())
+                return planned;
+
+            budget_us -= cost_us[next];
+            ++planned[next];
+        }
+    }
+
+    template <typename Test>
+    static std::optional<std::string> try_test(Test&& test, unsigned seed, bool memoize)
+    {
+        utils::rng.seed(utils::rng_seed = seed);
+
+        const bool memoizing = std::exchange(utils::memoize_transitions, memoize);
+        const size_t patience = std::exchange(utils::plateau_patience, plateau_patience);
+        const size_t graph_budget = std::exchange(utils::state_graph_budget, memory_ceiling ? std::min(memory_ceiling, state_graph_budget) : state_graph_budget);
+        const bool recording = std::exchange(utils::record_telemetry, telemetry);
+        const bool throwing = std::exchange(utils::throw_on_failure, true);
+        std::optional<std::string> failure;
+        try {
+            test();
+        }
+        catch (const utils::assertion_failure& e) {
+            failure = e.what();
+        }
+        utils::throw_on_failure = throwing;
+        utils::memoize_transitions = memoizing;
+        utils::plateau_patience = patience;
+        utils::state_graph_budget = graph_budget;
+        utils::record_telemetry = recording;
+        return failure;
+    }
+    // Clears the figures that a run reports but the whole process gathers, so that the report covers the run alone.
+    static void reset_run_figures()
+    {
+        utils::plateau_stops = 0;
+        utils::plateau_steps_saved = 0;
+        utils::reset_telemetry();
+    }
+    // Tells whether approximate learning was used and what it saved; empty if it was not.
+    static std::string approximation_report()
+    {
+        if (plateau_patience == 0)
+            return "";
+        return std::format("{} (plateau patience {}): {} sequences deemed unlearnable early, {} timesteps saved\n",
+            yellow("Approximate learning"), plateau_patience, utils::plateau_stops.load(), utils::plateau_steps_saved.load());
+    }
+    // One row per parameter point: the passed repetitions of each swept test, and the total cost in milliseconds.
+    template <typename Parameters>
+    static std::string sweep_table(const std::vector<SweepResult<Parameters>>& results)
+    {
+        std::string table = "\n Point";
+        for (size_t i = 0; i < testbed.size(); ++i)
+            if (results.front().passed[i])
+                table += std::format("{:>7}", std::format("#{}", i + 1));
+        table += "  Cost (ms)\n";
+
+        for (size_t k = 0; k < results.size(); ++k) {
+            const auto& result = results[k];
+            table += std::format("{:>6}", k);
+            std::chrono::microseconds cost{};
+            for (size_t i = 0; i < testbed.size(); ++i) {
+                if (not result.passed[i])
+                    continue;
+                table += std::format("{:>7}", std::format("{}/{}", *result.passed[i], result.repetitions));
+                cost += result.cost[i];
+            }
+            table += std::format("{:>11.1f}", cost.count() / 1000.0);
+            if constexpr (requires(std::ostream& out) { out << result.point; }) {
+                std::ostringstream point;
+                point << result.point;
+                table += "  " + point.str();
+            }
+            table += '\n';
+        }
+        return table;
+    }
+    static std::string telemetry_report()
+    {
+        return telemetry ? utils::collected_telemetry().report() : "";
+    }
+    // Whether repetitions of the indexed test replay memoized transitions; sizes the cache to the current budget.
+    static bool memoizes(size_t index)
+    {
+        if constexpr (Model::fingerprinted) {
+            Model::transitions().resize(transition_cache_size, transition_cache_size > 0 ? model_footprint() : 0);
+            return Model::transitions().enabled() and std::ranges::find(UnmemoizedTests, index + 1) == UnmemoizedTests.end();
+        }
+        else
+            return false;
+    }
+    static utils::RepetitionArena* repetition_arena()
+    {
+        static std::unique_ptr<utils::RepetitionArena> arena;
+        if (arena_size == 0)
+            arena.reset();
+        else if (not arena or arena->initial_size() < arena_size or arena->huge_pages() != arena_huge_pages)
+            arena = std::make_unique<utils::RepetitionArena>(arena_size, arena_huge_pages);
+        return arena.get();
+    }
+    // Measures the footprint where the memory ceiling or the transition cache needs it. Called before any workers
+    // start, as the measurement reads the resident memory of the whole process, which concurrent repetitions skew.
+    static void measure_footprint()
+    {
+        if (memory_ceiling > 0 or (Model::fingerprinted and transition_cache_size > 0))
+            model_footprint();
+    }
+    static size_t peak_memory(size_t index)
+    {
+        return PeakLiveModels[index] * model_footprint();
+    }
+    // The largest peak memory of a repetition over all tests.
+    static size_t peak_memory()
+    {
+        size_t peak = 0;
+        for (size_t i = 0; i < testbed.size(); ++i)
+            peak = std::max(peak, peak_memory(i));
+        return peak;
+    }
+    // What the parameter points of evaluate() and sweep() share: the seeds of their repetitions, and the number of
+    // points run concurrently, with the models measured at the first point.
+    template <typename Parameters>
+    static std::pair<std::vector<unsigned>, size_t> search_setup(const Parameters& first, size_t repetitions, unsigned seed)
+    {
+        std::vector<unsigned> seeds(std::max<size_t>(repetitions, 1));
+        std::ranges::generate(seeds, std::mt19937(seed));
+
+        SystemUnderEvaluation::configuration = &first;
+        const size_t workers = admissible_workers([]() { return peak_memory(); });
+        SystemUnderEvaluation::configuration = nullptr;
+        return { std::move(seeds), workers };
+    }
+    // The number of concurrent repetitions whose estimated peak memory fits the memory ceiling. The peak memory per
+    // worker is only estimated under a ceiling.
+    template <std::invocable Estimate>
+    static size_t admissible_workers(Estimate&& peak_memory_per_worker)
+    {
+        measure_footprint();
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        if (memory_ceiling == 0)
+            return cores;
+        const size_t peak = peak_memory_per_worker();
+        return peak == 0 ? cores : std::clamp<size_t>(memory_ceiling / peak, 1, cores);
+    }
+    // Evidence gathered by the sequential verdict of a statistical test.
+    struct Evidence
+    {
+        utils::SequentialProbabilityRatioTest sprt;
+        std::string failure;
+        unsigned failure_seed = 0;
+    };
+    static std::vector<std::optional<Evidence>> sequential_evidence()
+    {
+        std::vector<std::optional<Evidence>> evidence(testbed.size());
+        if (sequential_error_rate > 0)
+            for (unsigned test_number : StatisticalTests)
+                evidence[test_number - 1].emplace(utils::SequentialProbabilityRatioTest(AcceptableFailureRate, UnacceptableFailureRate,
+                    sequential_error_rate, sequential_error_rate));
+        return evidence;
+    }
+    // Runs one repetition of the indexed test and terminates the run if it fails. A test with a sequential
+    // verdict only fails once the evidence says so; the return value tells whether it has already passed.
+    static bool repeat(size_t index, unsigned seed, std::optional<Evidence>& evidence)
+    {
+        utils::RepetitionArena* arena = repetition_arena();
+        const auto failure = arena ? (*arena)([&]() { return attempt(index, seed); }) : attempt(index, seed);
+        if (not evidence) {
+            if (failure)
+                fail(index, *failure);
+            return false;
+        }
+
+        if (failure) {
+            evidence->failure = *failure;
+            evidence->failure_seed = seed;
+        }
+        const auto verdict = evidence->sprt.observe(failure.has_value());
+        settle(index, evidence, verdict);
+        return verdict == utils::SequentialProbabilityRatioTest::accept;
+    }
+    // Terminates the run if the sequential verdict, or the truncated one once the repetitions have run out, is a fail.
+    static void settle(size_t index, const std::optional<Evidence>& evidence)
+    {
+        if (evidence)
+            settle(index, evidence, evidence->sprt.truncated());
+    }
+    static void settle(size_t index, const std::optional<Evidence>& evidence, utils::SequentialProbabilityRatioTest::verdict verdict)
+    {
+        if (verdict == utils::SequentialProbabilityRatioTest::reject) {
+            utils::rng_seed = evidence->failure_seed;
+            fail(index, evidence->failure);
+        }
+    }
+    // Reports a failed repetition, or a failed case of an exhaustive test, records it in the failure corpus and
+    // terminates like a failed ASSERT. The report tells how to reproduce the failure.
+    [[noreturn]] static void fail(size_t index, const std::string& what, bool record = true, std::optional<size_t> exhaustive_case = {})
+    {
+        const std::string reproduction = exhaustive_case
+            ? std::format("exhaustive case: {}, replay with run(exhaustive, {}, {})", *exhaustive_case, index + 1, *exhaustive_case)
+            : std::format("rng_seed: {}", utils::rng_seed);
+        if (record and not failure_corpus.empty()) {
+            std::ofstream corpus(failure_corpus, std::ios::app);
+            if (exhaustive_case)
+                corpus << index + 1 << " case " << *exhaustive_case << '\n';
+            else
+                corpus << index + 1 << ' ' << utils::rng_seed << '\n';
+        }
+
+        std::cerr << std::format("\n\n{}\n{}\n{}\n{}", std::get<std::string>(testbed[index]), what, reproduction, approximation_report() + telemetry_report());
+        exit(-1);
+    }
+    // A recorded failure: the seed of a failed repetition, or the failed case of an exhaustive test.
+    struct CorpusEntry
+    {
+        unsigned test_number;
+        size_t seed_or_case;
+        bool exhaustive_case;
+
+        auto operator<=>(const CorpusEntry&) const = default;
+    };
+    // Reads lines of "<test number> <seed>" and "<test number> case <case>".
+    static std::vector<CorpusEntry> read_failure_corpus()
+    {
+        std::vector<CorpusEntry> corpus;
+        std::ifstream in(failure_corpus);
+        for (std::string line; std::getline(in, line); ) {
+            std::istringstream fields(line);
+            unsigned test_number;
+            std::string word;
+            size_t value;
+            if (not (fields >> test_number >> word) or test_number == 0 or test_number > testbed.size())
+                continue;
+            if (word == "case") {
+                if (fields >> value and exhaustive_variant(test_number - 1) and value < std::get<size_t>(*exhaustive_variant(test_number - 1)))
+                    corpus.push_back({ test_number, value, true });
+            }
+            else if (std::istringstream(word) >> value)
+                corpus.push_back({ test_number, value, false });
+        }
+        return corpus;
+    }
+    // Replays every recorded failure before the randomized schedule starts, so that a model which still fails
+    // a known case is rejected within seconds. The cases run in parallel, except for the real-time test, whose
+    // wall-clock measurements must not compete with other work.
+    static void replay_failure_corpus()
+    {
+        auto corpus = read_failure_corpus();
+        std::ranges::sort(corpus);
+        corpus.erase(std::ranges::unique(corpus).begin(), corpus.end());
+        if (corpus.empty())
+            return;
+
+        std::clog << "\nReplaying " << corpus.size() << " recorded failures...\n";
+
+        std::mutex mutex;
+        std::optional<std::pair<CorpusEntry, std::string>> first_failure;
+        auto replay = [&](const CorpusEntry& entry) -> bool {
+            const size_t index = entry.test_number - 1;
+            const auto failure = entry.exhaustive_case ? replay_case(index, entry.seed_or_case) : attempt(index, (unsigned)entry.seed_or_case);
+            if (failure) {
+                std::lock_guard lock(mutex);
+                if (not first_failure)
+                    first_failure.emplace(entry, *failure);
+            }
+            return not failure;
+        };
+
+        const auto timing_sensitive = std::ranges::stable_partition(corpus, [](const auto& entry) { return entry.test_number != RealTimeLiveness; });
+        const size_t workers = admissible_workers([&]() {
+            size_t peak = 0;
+            for (const CorpusEntry& entry : corpus)
+                peak = std::max(peak, peak_memory(entry.test_number - 1));
+            return peak;
+        });
+        utils::parallel_for(corpus.size() - timing_sensitive.size(), [&](size_t k) { return replay(corpus[k]); }, workers);
+        for (const auto& entry : timing_sensitive)
+            if (not first_failure and not replay(entry))
+                break;
+
+        if (first_failure) {
+            const auto& [entry, what] = *first_failure;
+            if (entry.exhaustive_case)
+                fail(entry.test_number - 1, what, false, entry.seed_or_case);
+            utils::rng_seed = (unsigned)entry.seed_or_case;
+            fail(entry.test_number - 1, what, false);
+        }
+    }
+
+    // The number of distinct inputs if it is at most MaxExhaustiveCases, or else 0.
+    static consteval size_t distinct_inputs()
+    {
+        size_t count = 1;
+        for (size_t bit = 0; bit < BitsPerInput and count <= MaxExhaustiveCases; ++bit)
+            count *= 2;
+        return count <= MaxExhaustiveCases ? count : 0;
+    }
+    // All distinct inputs if there are at most MaxInputsPerSweep of them, or else an evenly spread selection.
+    static std::vector<Input> input_sweep() { return utils::covering_inputs<Input>(MaxInputsPerSweep); }
+
+    static void absolute_refractory_period(const Input& x)
+    {
+        if (x.any()) {
+            const InputSequence no_consecutive_spikes = { x, ~x };
+            const InputSequence consecutive_spikes = { x, x };
+
+            Model A, B;
+
+            ASSERT(A.learn(no_consecutive_spikes));
+            ASSERT(not B.learn(consecutive_spikes));
+        }
+    }
+    // Tests whose cases can be enumerated: (test number, number of cases, test of the k-th case).
+    // Test #4 already sweeps all complementary input pairs in every repetition and only samples the model
+    // state, and test #3 runs its single edge case once, so neither has a finite case list to cover. A variant with
+    // no cases is left out of exhaustive runs.
+    static inline const std::vector<std::tuple<unsigned, size_t, void(*)(size_t)>> exhaustive_variants =
+    {
+        { 5, distinct_inputs(), [](size_t k) { absolute_refractory_period(Input(k)); } },
+    };
     static inline const std::vector<std::tuple<std::string, test_repetitions, void(*)()>> testbed =
     {
         {
@@ -113,9 +942,13 @@ private:
             "#2 Determinism", 
             RepeatForever,
             []() {
+                if (const auto* graph = Model::state_graph()) {
+                    ASSERT(graph->deterministic());                     // on every reachable state and input
+                    return;
+                }
                 const Model R(Model::random);
 
-                for (const Input& x : all_distinct_inputs) {
+                for (const Input& x : input_sweep()) {
                     Model A = R, B = R;
                     A << x;
                     B << x;
@@ -131,14 +964,20 @@ private:
             RepeatOnce,
             []() {
                 Model A;                                                // edge case Input{}^5000
-                std::vector<Model> trajectory;
-                trajectory.reserve(SimulatedInfinity);
-                
-                while (trajectory.size() < SimulatedInfinity) {         // A << std::views::repeat(Input{}, SimulatedInfinity);
-                    trajectory.push_back(A);
-                    A << Input{};
+                if (const auto* graph = Model::state_graph()) {
+                    ASSERT(not graph->revisits(Input{}, SimulatedInfinity));
+                    A << std::views::repeat(Input{}, SimulatedInfinity);
+                }
+                else {
+                    utils::StateSet<Model> trajectory;
+                    trajectory.reserve(SimulatedInfinity);
 
-                    ASSERT(std::find(trajectory.begin(), trajectory.end(), A) == trajectory.end());
+                    while (trajectory.size() < SimulatedInfinity) {     // A << std::views::repeat(Input{}, SimulatedInfinity);
+                        trajectory.insert(A);
+                        A << Input{};
+
+                        ASSERT(not trajectory.contains(A));
+                    }
                 }
 
                 Model B; 
@@ -162,7 +1001,7 @@ private:
                 Model A(Model::random);
 
                 auto complementary_inputs = [](const Input& x) { return x.count() <= BitsPerInput / 2; };
-                for (const Input& x : all_distinct_inputs | std::views::filter(complementary_inputs)) {
+                for (const Input& x : input_sweep() | std::views::filter(complementary_inputs)) {
                     Model _A = A, _B = A;
                     _A << x << ~x;
                     _B << ~x << x;
@@ -176,16 +1015,7 @@ private:
             "#5 Absolute refractory period",
             RepeatForever,
             []() {
-                const Input x = random<Input>();    // for(x:all_distinct_inputs) is best but slow on ::run(1)
-                if (x.any()) {
-                    const InputSequence no_consecutive_spikes = { x, ~x };
-                    const InputSequence consecutive_spikes = { x, x };
-
-                    Model A, B;
-
-                    ASSERT(A.learn(no_consecutive_spikes));
-                    ASSERT(not B.learn(consecutive_spikes));
-                }
+                absolute_refractory_period(random<Input>());    // run(exhaustive) covers all distinct inputs
             }
         },
         {
@@ -197,16 +1027,20 @@ private:
                     for (time_t time = 0; time < SimulatedInfinity; ++time) {
                         const InputSequence learnable_sequence = Model::learnable_random_sequence(SequenceLength);
 
-                        if (not A.learn(learnable_sequence))
+                        if (not A.learn(learnable_sequence)) {
+                            if (utils::record_telemetry)
+                                utils::telemetry().sequences_before_saturation.add(time);
                             return true;
+                        }
                     }
                     return false;
                 };
                 auto universal_learnability_of_admissible_length_2_sequences = [](const Model& A) -> bool {
                     auto admissible = [](const Input& x1, const Input& x2) -> bool { return (x1 & x2).none(); };
 
-                    for (const Input& x1 : all_distinct_inputs) {
-                        for (const Input& x2 : all_distinct_inputs) {
+                    const std::vector<Input> inputs = input_sweep();
+                    for (const Input& x1 : inputs) {
+                        for (const Input& x2 : inputs) {
                             if (!admissible(x1, x2))
                                 continue;
 
@@ -243,15 +1077,14 @@ private:
             []() {
                 // Null Hypothesis: Adaptation time is independent of the input sequence content
                 auto adaptation_time_is_input_dependent = []() -> bool {
-                    Model A;
+                    Model A, B;
                     const InputSequence base_seq = Model::learnable_random_sequence(SequenceLength);
                     const time_t time_base_seq = A.time_to_learn(base_seq);
                     for (size_t attempts = 0; attempts < SimulatedInfinity; ++attempts) {
                         const InputSequence seq(InputSequence::circular_random, SequenceLength);    // admissible by construction
 
                         if (seq != base_seq) {
-                            Model B;
-                            const time_t time_seq = B.time_to_learn(seq);
+                            const time_t time_seq = B.reset().time_to_learn(seq);
                             const bool seq_learnable = time_seq != SimulatedInfinity;
                             if (seq_learnable and time_seq != time_base_seq)                         // rejects the null hypothesis
                                 return true;
@@ -299,11 +1132,12 @@ private:
                 size_t model_score = 0, baseline_0_score = 0, baseline_1_score = 0;
                 const int num_of_runs = 20;                                 // within each of 5,000 trials
                 const int n = 5;                                            // informing context length
+                Model fresh;
                 for (int i = 0; i < num_of_runs; ++i) {
                     const InputSequence reality(InputSequence::circular_random, SequenceLength);
                     const Input true_elt = reality[0];
                     if (const auto corrupted_elt = corrupt(true_elt, reality.back(), reality[1])) {
-                        Model A;
+                        Model& A = fresh.reset();
                         for (int j = 0; j < n; ++j)
                             A << reality;                                   // inform the model about the reality
 
@@ -373,8 +1207,9 @@ private:
                     InputSequence chunk(InputSequence::random, 2ull);
                     while (true) {
                         std::vector<time_t> time_probes(tuning_samples);
+                        Model M;
                         for (time_t& time : time_probes) {
-                            Model M;
+                            M.reset();
                             time = utils::time_it([&]() { M << chunk; });
                         }
                         const auto [median, _] = utils::percentiles(time_probes);
@@ -411,27 +1246,140 @@ private:
                     ASSERT(p95 <= median * jitter_tolerance);           // bounded worst case
                 };
 
-                auto periodic_chunk = [](const InputSequence& motif, size_t chunk_size) {
-                    InputSequence chunk; chunk.reserve(chunk_size);
-                    for (size_t k = 0; k < chunk_size; ++k)
-                        chunk.push_back(motif[k % motif.size()]);
-
-                    chunk.back() = chunk.back() & ~chunk.front();       // ARP
-                    return chunk;
-                };
-
+                // chunks are generated while they are fed, as a stream of inputs would be
                 static const size_t chunk_size = autotune_chunk_size();
-                assert_live_on([&]() { return InputSequence(InputSequence::random, chunk_size); });
-                assert_live_on([&]() { return InputSequence(InputSequence::trivial, chunk_size); });
+                assert_live_on([&]() { return InputSequence::lazy(InputSequence::random, chunk_size); });
+                assert_live_on([&]() { return InputSequence::lazy(InputSequence::trivial, chunk_size); });
 
                 for (size_t i = 0; i < 10; ++i) {
                     const size_t pattern_period = utils::random(2, 4 * SequenceLength);
                     const InputSequence motif(InputSequence::circular_random, pattern_period);
-                    assert_live_on([&]() { return periodic_chunk(motif, chunk_size); });
+                    assert_live_on([&]() { return InputSequence::lazy(InputSequence::periodic, motif, chunk_size); });
                 }
             } 
         }
     };
 };
+
+// Runs the tests on several model types side by side with common random numbers: in each repetition, every model
+// is run from the same seed and so draws the same random inputs, as far as its own behaviour leaves the draws alike.
+// Differences between the results then stem from the models rather than from the luck of their draws.
+template <typename... Systems>
+    requires (sizeof...(Systems) > 0)
+class Tournament
+{
+    using Reference = TestBed<std::tuple_element_t<0, std::tuple<Systems...>>>;
+    static constexpr size_t Models = sizeof...(Systems);
+
+public:
+    // Runs all tests on all models, the models of a repetition in parallel, as far as the memory ceiling of the
+    // first model's TestBed admits, except for the real-time test, and reports the results per test. A model that fails a test skips its remaining repetitions of that test.
+    // Returns which of the models passed every test.
+    static std::array<bool, Models> run(size_t repetitions_override = 0)
+    {
+        std::clog << "Artificial General Intelligence Testbed\n";
+        std::clog << "\n\nRunning 12 tests on " << Models << " models...\n";
+        const std::string go_back(20, '\b');
+        std::mt19937 seeds(utils::rng());
+
+        static constexpr std::array<std::optional<std::string>(*)(size_t, unsigned), Models> attempts = { &TestBed<Systems>::attempt... };
+        (TestBed<Systems>::measure_footprint(), ...);                 // before the models of a repetition run in parallel
+        std::vector<std::array<Result, Models>> results(Reference::testbed.size());
+        for (size_t i = 0; i < Reference::testbed.size(); ++i) {
+            const auto& [info, repetitions, test] = Reference::testbed[i];
+            std::clog << info << "  " << std::endl;
+
+            auto& row = results[i];
+            const size_t workers = Reference::admissible_workers([i]() { return std::max({ TestBed<Systems>::peak_memory(i)... }); });
+            const size_t test_repetitions = repetitions_override == 0 ? (size_t)repetitions : std::min((size_t)repetitions, (size_t)repetitions_override);
+            for (size_t r = 1; r <= test_repetitions; ++r) {
+                std::clog << r << '/' << test_repetitions << "   " << go_back;
+
+                const unsigned seed = seeds();
+                auto play = [&](size_t m) {
+                    if (not row[m].failure) {
+                        std::optional<std::string> failure;
+                        row[m].time_us += utils::time_it([&]() { failure = attempts[m](i, seed); });
+                        ++row[m].repetitions;
+                        if (failure) {
+                            row[m].failure = *failure;
+                            row[m].failure_seed = seed;
+                        }
+                    }
+                    return true;
+                };
+                if (i + 1 == Reference::RealTimeLiveness)
+                    for (size_t m = 0; m < Models; ++m)
+                        play(m);
+                else
+                    utils::parallel_for(Models, play, workers);
+
+                if (std::ranges::all_of(row, [](const Result& result) { return result.failure.has_value(); }))
+                    break;
+            }
+        }
+
+        report(results);
+        std::array<bool, Models> passed;
+        for (size_t m = 0; m < Models; ++m)
+            passed[m] = std::ranges::none_of(results, [&](const auto& row) { return row[m].failure.has_value(); });
+        return passed;
+    }
+
+private:
+    struct Result
+    {
+        size_t repetitions = 0;
+        time_t time_us = 0;
+        std::optional<std::string> failure;
+        unsigned failure_seed = 0;
+    };
+
+    // A table of passed repetitions and mean time per repetition, or the seed of the failure, per test and model.
+    static void report(const std::vector<std::array<Result, Models>>& results)
+    {
+        static const std::array<std::string, Models> types = { name_of<Systems>()... };
+
+        std::clog << "\n\nResults (passed repetitions, mean time per repetition):\n" << std::format("{:<32}", "");
+        for (size_t m = 0; m < Models; ++m)
+            std::clog << std::format("{:>24}", std::format("Model {}", m + 1));
+        std::clog << '\n';
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            std::clog << std::format("{:<32}", std::get<std::string>(Reference::testbed[i]));
+            for (const Result& result : results[i]) {
+                const std::string cell = result.failure
+                    ? std::format("FAIL rng_seed: {}", result.failure_seed)
+                    : std::format("{} in {:.2f} ms", result.repetitions, result.repetitions ? result.time_us / 1000.0 / result.repetitions : 0.0);
+                std::clog << std::format("{:>24}", cell);
+            }
+            std::clog << '\n';
+        }
+
+        std::clog << '\n';
+        for (size_t m = 0; m < Models; ++m)
+            std::clog << "Model " << m + 1 << ": " << types[m] << '\n';
+        for (size_t i = 0; i < results.size(); ++i)
+            for (size_t m = 0; m < Models; ++m)
+                if (const Result& result = results[i][m]; result.failure)
+                    std::clog << std::format("\nModel {} failed {}\n{}rng_seed: {}\n", m + 1, std::get<std::string>(Reference::testbed[i]), *result.failure, result.failure_seed);
+    }
+    // The name a model type gives itself, or else its type name, demangled where the compiler tells how.
+    template <typename M>
+    static std::string name_of()
+    {
+        if constexpr (requires { { M::name } -> std::convertible_to<std::string>; })
+            return M::name;
+        else {
+#if __has_include(<cxxabi.h>)
+            int status = 0;
+            const std::unique_ptr<char, void(*)(void*)> demangled(abi::__cxa_demangle(typeid(M).name(), nullptr, nullptr, &status), std::free);
+            if (status == 0)
+                return demangled.get();
+#endif
+            return typeid(M).name();
+        }
+    }
+};
 }
 }
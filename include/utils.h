@@ -26,13 +26,34 @@
 #include <ranges>
 #include <random>
 #include <cassert>
+#include <cmath>
+#include <numeric>
+#include <unordered_set>
+#include <set>
+#include <unordered_map>
+#include <optional>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory_resource>
+#include <array>
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <bit>
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace sprogar {
 
 #define ASSERT(expression) (void)((!!(expression)) || \
-                            (std::cerr << std::format("\n\n{} in {}:{}\n{}\n\nrng_seed: {}\n", \
-                                red("Assertion failed"), __FILE__, __LINE__, #expression, utils::rng_seed), \
-                            exit(-1), 0))
+                            (utils::assertion_failed(#expression, __FILE__, __LINE__), 0))
 
 inline std::string red(const char* msg) { return std::format("\033[91m{}\033[0m", msg); }
 inline std::string green(const char* msg) { return std::format("\033[92m{}\033[0m", msg); }
@@ -44,8 +65,42 @@ inline namespace utils {
 
     constexpr time_t Infinity = std::numeric_limits<time_t>::max();
 
-    static unsigned rng_seed = std::random_device{}();
-    static std::mt19937 rng(rng_seed);
+    static thread_local unsigned rng_seed = std::random_device{}();
+    static thread_local std::mt19937 rng(rng_seed);
+
+    // Thrown by a failed ASSERT instead of terminating the process, for runners that handle failures themselves.
+    struct assertion_failure : std::runtime_error
+    {
+        using std::runtime_error::runtime_error;
+    };
+    static thread_local bool throw_on_failure = false;
+
+    // Whether models stepped on this thread replay transitions from their TransitionCache.
+    static thread_local bool memoize_transitions = false;
+
+    // Opt-in approximate learning on this thread: time_to_learn() gives up on a sequence once the match score of
+    // its passes has not improved for this many passes; 0 disables it. Sequences given up, and the timesteps the
+    // remaining passes would have taken, are counted across all threads.
+    static thread_local size_t plateau_patience = 0;
+    inline std::atomic<size_t> plateau_stops = 0, plateau_steps_saved = 0;
+
+    // Whether learning on this thread is recorded in its LearningTelemetry.
+    static thread_local bool record_telemetry = false;
+
+    // Memory in bytes that the transition graph of a finite-state model may take, when it is first built on this thread.
+    static thread_local size_t state_graph_budget = size_t{ 1 } << 30;
+
+    [[noreturn]] inline void assertion_failed(const char* expression, const char* file, int line)
+    {
+        const std::string what = std::format("{} in {}:{}\n{}\n", red("Assertion failed"), file, line, expression);
+        if (throw_on_failure)
+            throw assertion_failure(what);
+
+        std::cerr << std::format("\n\n{}\nrng_seed: {}\n", what, rng_seed);
+        if (plateau_patience > 0)
+            std::cerr << std::format("{} (plateau patience {})\n", yellow("Approximate learning"), plateau_patience);
+        exit(-1);
+    }
 
     template <typename M, typename T>
     concept InputPredictor = std::regular<M>
@@ -54,6 +109,72 @@ inline namespace utils {
         { c(t) } -> std::convertible_to<T>;
     };
 
+    // Optional capability of a model to return to its uninformed start in place.
+    template <typename M>
+    concept Resettable = requires(M m)
+    {
+        m.reset();
+    };
+
+    // Optional capability of a model to summarise its state in a hash; equal models must have equal hashes.
+    template <typename M>
+    concept StateHashable = requires(const M& m)
+    {
+        { std::hash<M>{}(m) } -> std::convertible_to<size_t>;
+    };
+
+    // Models made of plain bytes, such as arrays of integers, that declare `static constexpr bool byte_comparable
+    // = true`: equal exactly when their bytes are equal, so they are compared and hashed bytewise. The declaration
+    // is required, as a model may define an equality that ignores some of its bytes.
+    template <typename M>
+    concept ByteComparable = std::is_trivially_copyable_v<M> and std::has_unique_object_representations_v<M>
+        and requires { requires bool(M::byte_comparable); };
+
+    template <typename M>
+    concept Fingerprintable = StateHashable<M> or ByteComparable<M>;
+
+    // Optional capability of a model to declare that it has at most max_states reachable states, which lets
+    // AGITB analyse its explicit transition graph instead of simulating it.
+    template <typename M>
+    concept FiniteState = Fingerprintable<M> and requires
+    {
+        { M::max_states } -> std::convertible_to<size_t>;
+    };
+
+    // Models constructed from a parameter point of the calling thread, such as Configured: two default-constructed
+    // models may differ from one thread or evaluation to the next, so they are never cloned from a prototype.
+    template <typename M>
+    concept Parameterised = requires
+    {
+        typename M::parameters_type;
+    };
+
+    // Inputs that can be enumerated by their index, such as std::bitset.
+    template <typename T>
+    concept EnumerableInput = std::constructible_from<T, unsigned long long> and requires(const T& x)
+    {
+        { x.to_ulong() } -> std::convertible_to<size_t>;
+    };
+
+    // Hash of a model state. A hash provided by the model takes precedence over hashing the bytes of a byte-comparable model.
+    template <Fingerprintable M>
+    size_t fingerprint_of(const M& m)
+    {
+        if constexpr (StateHashable<M>)
+            return std::hash<M>{}(m);
+        else
+            return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char*>(&m), sizeof(M)));
+    }
+
+    template <typename M>
+    bool equal_states(const M& a, const M& b)
+    {
+        if constexpr (ByteComparable<M>)
+            return std::memcmp(&a, &b, sizeof(M)) == 0;
+        else
+            return a == b;
+    }
+
     template <size_t BitsPerInput>
     size_t match_score(const std::bitset<BitsPerInput>& a, const std::bitset<BitsPerInput>& b)
     {
@@ -100,19 +221,242 @@ inline namespace utils {
     }
 
 
+    // Returns at most `count` distinct inputs spread evenly over the input space. A space that fits entirely is
+    // returned whole and in order. Otherwise the selection starts with a binary covering array of strength 2,
+    // in which every pair of bits takes all four value combinations, and its complement; the rest is a random
+    // sample stratified by the number of spikes, so that sparse and dense inputs are equally represented.
     template <typename Input>
-    class InputSequence : public std::vector<Input>
+    std::vector<Input> covering_inputs(size_t count)
+    {
+        const size_t bits = Input{}.size();
+        std::vector<Input> inputs;
+        if (std::bit_width(count) > bits) {                             // 2^bits <= count
+            for (size_t i = 0; std::bit_width(i) <= bits; ++i)
+                inputs.emplace_back(i);
+            return inputs;
+        }
+
+        std::unordered_set<Input> selected;
+        auto select = [&](const Input& x) {
+            if (inputs.size() < count and selected.insert(x).second)
+                inputs.push_back(x);
+        };
+
+        // Rows of the covering array: row 0 is empty, and each bit is a distinct column of rows 1..N-1 with
+        // ceil(N/2) spikes, so any two columns differ somewhere and, being over half full, also overlap.
+        auto binomial = [](size_t n, size_t k) {
+            double c = 1;
+            for (size_t i = 1; i <= k; ++i)
+                c = c * (n - k + i) / i;
+            return c;
+        };
+        size_t N = 2;
+        while (binomial(N - 1, (N + 1) / 2) < bits)
+            ++N;
+        std::vector<Input> rows(N);
+        for (size_t bit = 0, column = (size_t{ 1 } << (N + 1) / 2) - 1; bit < bits; ++bit) {
+            for (size_t row = 1; row < N; ++row)
+                rows[row][bit] = column >> (row - 1) & 1;
+
+            const size_t lowest = column & -column, ripple = column + lowest;        // next column of equal weight
+            column = ripple | (((column ^ ripple) >> 2) / lowest);
+        }
+        for (const Input& row : rows) {
+            select(row);
+            select(~row);
+        }
+
+        for (size_t attempt = 0, spikes = 0; inputs.size() < count and attempt < 16 * count; ++attempt, spikes = (spikes + 1) % (bits + 1)) {
+            std::vector<size_t> positions(bits);
+            std::iota(positions.begin(), positions.end(), 0);
+            std::shuffle(positions.begin(), positions.end(), rng);
+
+            Input x{};
+            for (size_t i = 0; i < spikes; ++i)
+                x[positions[i]] = true;
+            select(x);
+        }
+        return inputs;
+    }
+
+/**
+ * Memory of a single repetition: small blocks are carved from a monotonic arena and recycled through
+ * per-size free lists, and all of it is released at once when the repetition ends. Large blocks go
+ * straight to the general-purpose heap.
+ *
+ * While a repetition runs, the arena is the default memory resource, so InputSequence and every
+ * allocator-aware model (one built from std::pmr containers) allocate from it instead of the
+ * general-purpose heap. The initial arena block can be backed by transparent huge pages on Linux.
+ * Because the default memory resource is process-wide, an arena serves serial runs only.
+ **/
+    class RepetitionArena : public std::pmr::memory_resource
+    {
+    public:
+        RepetitionArena(size_t initial_size, bool huge_pages)
+            : size(round_up(initial_size, huge_pages ? HugePageSize : Granule)), huge(huge_pages),
+              buffer(::operator new(size, std::align_val_t{ huge ? HugePageSize : Granule })),
+              arena(buffer, size, std::pmr::new_delete_resource())
+        {
+#ifdef MADV_HUGEPAGE
+            if (huge)
+                madvise(buffer, size, MADV_HUGEPAGE);
+#endif
+        }
+        RepetitionArena(const RepetitionArena&) = delete;
+        RepetitionArena& operator=(const RepetitionArena&) = delete;
+        ~RepetitionArena()
+        {
+            release();
+            ::operator delete(buffer, size, std::align_val_t{ huge ? HugePageSize : Granule });
+        }
+
+        size_t initial_size() const { return size; }
+        bool huge_pages() const { return huge; }
+
+        // Runs f with the arena as the default memory resource and releases everything allocated meanwhile.
+        template <typename Func>
+        auto operator()(Func&& f)
+        {
+            struct scope
+            {
+                RepetitionArena& owner;
+                std::pmr::memory_resource* previous;
+                ~scope()
+                {
+                    std::pmr::set_default_resource(previous);
+                    owner.release();
+                }
+            } active{ *this, std::pmr::set_default_resource(this) };
+
+            return f();
+        }
+
+    private:
+        static constexpr size_t HugePageSize = 2 << 20, Granule = alignof(std::max_align_t), SizeClasses = 64, ChunkSize = 64 << 10;
+        static size_t round_up(size_t n, size_t multiple) { return (std::max<size_t>(n, 1) + multiple - 1) / multiple * multiple; }
+
+        struct FreeBlock { FreeBlock* next; };
+
+        size_t size;
+        bool huge;
+        void* buffer;
+        std::pmr::monotonic_buffer_resource arena;
+        std::array<FreeBlock*, SizeClasses + 1> free_lists{};
+        std::byte* cursor = nullptr;
+        std::byte* end = nullptr;
+
+        void release()
+        {
+            free_lists.fill(nullptr);
+            cursor = end = nullptr;
+            arena.release();
+        }
+
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            const size_t size_class = std::max<size_t>((bytes + Granule - 1) / Granule, 1);
+            if (size_class > SizeClasses or alignment > Granule)
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+
+            if (FreeBlock* block = free_lists[size_class]) {
+                free_lists[size_class] = block->next;
+                return block;
+            }
+            if ((size_t)(end - cursor) < size_class * Granule) {
+                cursor = static_cast<std::byte*>(arena.allocate(ChunkSize, Granule));
+                end = cursor + ChunkSize;
+            }
+            return std::exchange(cursor, cursor + size_class * Granule);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override
+        {
+            const size_t size_class = std::max<size_t>((bytes + Granule - 1) / Granule, 1);
+            if (size_class > SizeClasses or alignment > Granule)
+                return std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+
+            free_lists[size_class] = new (p) FreeBlock{ free_lists[size_class] };
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    // Runs f with the general-purpose heap as the default memory resource, for objects that must outlive any
+    // RepetitionArena that happens to be active.
+    template <typename Func>
+    auto on_heap(Func&& f)
+    {
+        struct scope
+        {
+            std::pmr::memory_resource* previous;
+            ~scope() { std::pmr::set_default_resource(previous); }
+        } active{ std::pmr::set_default_resource(std::pmr::new_delete_resource()) };
+
+        return f();
+    }
+
+    // Single-pass view of `length` inputs produced as they are consumed: the first one is given, and every next one
+    // is next(previous, first, t, length) at time t. Producing an input may draw random numbers, so the inputs can
+    // be read only once and in order, and the view can be moved but not copied.
+    template <typename Input>
+    class InputStream : public std::ranges::view_interface<InputStream<Input>>
     {
-        using base = std::vector<Input>;
+    public:
+        using next_input = Input(*)(const Input& previous, const Input& first, time_t t, time_t length);
+
+        InputStream(const Input& first, time_t length, next_input next) : current(first), first(first), length(length), next(next) {}
+        InputStream(InputStream&&) = default;
+        InputStream& operator=(InputStream&&) = default;
+
+        class iterator
+        {
+        public:
+            using value_type = Input;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            explicit iterator(InputStream* stream) : stream(stream) {}
+
+            const Input& operator*() const { return stream->current; }
+            iterator& operator++()
+            {
+                if (++stream->time < stream->length)
+                    stream->current = stream->next(stream->current, stream->first, stream->time, stream->length);
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+            bool operator==(std::default_sentinel_t) const { return stream->time >= stream->length; }
+
+        private:
+            InputStream* stream = nullptr;
+        };
+
+        iterator begin() { return iterator(this); }
+        std::default_sentinel_t end() const { return {}; }
+
+    private:
+        Input current, first;
+        time_t time = 0, length;
+        next_input next;
+    };
+
+    template <typename Input>
+    class InputSequence : public std::pmr::vector<Input>
+    {
+        using base = std::pmr::vector<Input>;
     public:
         enum random_tag { random = 0 };
         enum circular_random_tag { circular_random = 0 };
         enum trivial_tag { trivial = 0 };
+        enum periodic_tag { periodic = 0 };
 
         InputSequence() {}
-        InputSequence(std::initializer_list<Input> il) : std::vector<Input>(il) {}
+        InputSequence(std::initializer_list<Input> il) : base(il) {}
 
+        // never takes a tag, which would otherwise be taken for a size whenever the length is not exactly a time_t
         template<typename... Args>
+            requires (not std::is_enum_v<std::remove_cvref_t<Args>> and ...)
         InputSequence(Args&&... args) : base(std::forward<Args>(args)...) {}
 
         // constructs a random sequence of inputs with a specified length.
@@ -140,8 +484,490 @@ inline namespace utils {
             base::resize( length );
             base::back() = ~Input{};                // [{0...0}, {0...0}, ..., {0...0}, {1...1}]
         }
+
+        // constructs a sequence of the given length that repeats the motif, with the last input obeying the 
+        // refractory period of the first one.
+        InputSequence(periodic_tag, const InputSequence& motif, time_t length)
+        {
+            base::reserve(length);
+            std::ranges::copy(lazy(periodic, motif, length), std::back_inserter(*this));
+        }
+
+        // Lazy counterparts of the constructors above: views that produce the same inputs while they are consumed,
+        // instead of storing them. Random inputs are drawn as they are consumed, except for the first one, which is
+        // drawn immediately, so the random generator is used as by the constructors; their views are single-pass.
+        static InputStream<Input> lazy(random_tag, time_t length, Input start=utils::random<Input>())
+        {
+            return InputStream<Input>(start, length, [](const Input& previous, const Input&, time_t, time_t) {
+                return utils::random<Input>(previous);
+            });
+        }
+        static InputStream<Input> lazy(circular_random_tag, time_t length, Input start=utils::random<Input>())
+        {
+            return InputStream<Input>(start, length, [](const Input& previous, const Input& first, time_t t, time_t length) {
+                if (t + 1 < length)
+                    return utils::random<Input>(previous);
+                utils::random<Input>(previous);                             // drawn and replaced by the constructor too
+                return utils::random<Input>(previous, first);
+            });
+        }
+        static auto lazy(trivial_tag, time_t length)
+        {
+            return std::views::iota(time_t{ 0 }, length)
+                | std::views::transform([length](time_t t) { return t + 1 == length ? ~Input{} : Input{}; });
+        }
+        // The view refers to the motif, which must outlive it.
+        static auto lazy(periodic_tag, const InputSequence& motif, time_t length)
+        {
+            return std::views::iota(time_t{ 0 }, length)
+                | std::views::transform([&motif, length](time_t t) {
+                    const Input& x = motif[t % motif.size()];
+                    return t + 1 == length ? x & ~motif.front() : x;         // ARP
+                });
+        }
      };
 
+    // A set of model states that looks states up by their fingerprints where the model has them.
+    template <typename Model>
+    class StateSet
+    {
+    public:
+        void reserve(size_t n)
+        {
+            states.reserve(n);
+            if constexpr (Model::fingerprinted)
+                index.reserve(n);
+        }
+        size_t size() const { return states.size(); }
+
+        void insert(const Model& state)
+        {
+            if constexpr (Model::fingerprinted)
+                index.emplace(state.fingerprint(), states.size());
+            states.push_back(state);
+        }
+        bool contains(const Model& state) const
+        {
+            if constexpr (Model::fingerprinted) {
+                const auto [first, last] = index.equal_range(state.fingerprint());
+                return std::any_of(first, last, [&](const auto& entry) { return states[entry.second] == state; });
+            }
+            else
+                return std::find(states.begin(), states.end(), state) != states.end();
+        }
+
+    private:
+        std::vector<Model> states;
+        std::unordered_multimap<size_t, size_t> index;
+    };
+
+    // Distribution of non-negative values in power-of-two buckets: bucket 0 holds 0 and bucket k holds [2^(k-1), 2^k).
+    class Histogram
+    {
+    public:
+        void add(size_t value)
+        {
+            ++buckets[std::bit_width(value)];
+            ++n;
+            sum += (double)value;
+        }
+        Histogram& operator+=(const Histogram& other)
+        {
+            for (size_t k = 0; k < buckets.size(); ++k)
+                buckets[k] += other.buckets[k];
+            n += other.n;
+            sum += other.sum;
+            return *this;
+        }
+        size_t count() const { return n; }
+        double total() const { return sum; }
+        double mean() const { return n ? sum / n : 0.0; }
+
+        // One line per bucket between the lowest and the highest occupied one, with a bar of up to 40 characters.
+        std::string render() const
+        {
+            const auto occupied = [](size_t count) { return count > 0; };
+            const size_t first = std::ranges::find_if(buckets, occupied) - buckets.begin();
+            const size_t last = buckets.rend() - std::ranges::find_if(buckets | std::views::reverse, occupied);
+            const size_t highest = n ? std::ranges::max(buckets) : 1;
+
+            std::string lines;
+            for (size_t k = first; k < last; ++k) {
+                const size_t lo = k ? size_t{ 1 } << (k - 1) : 0, hi = k ? (lo << 1) - 1 : 0;
+                lines += std::format("{:>24}{:>10}  {}\n", lo == hi ? std::format("{}", lo) : std::format("{}-{}", lo, hi),
+                    buckets[k], std::string((buckets[k] * 40 + highest - 1) / highest, '#'));
+            }
+            return lines;
+        }
+
+    private:
+        std::array<size_t, std::numeric_limits<size_t>::digits + 1> buckets{};
+        size_t n = 0;
+        double sum = 0.0;
+    };
+
+/**
+ * What the learning episodes of a run looked like: how long adaptation took, how the share of correctly
+ * predicted bits grew from pass to pass, and how many sequences a model learned before it saturated.
+ * Each thread records into its own copy, at the cost of a few additions per pass, which is merged into
+ * the process-wide total when the thread ends.
+ **/
+    struct LearningTelemetry
+    {
+        static constexpr size_t CurveBuckets = 16;              // passes 0, 1, 2-3, 4-7, ..., 2^14 and more
+
+        Histogram adaptation_times;                             // timesteps, per learned sequence
+        size_t unlearned = 0;                                   // sequences not learned
+        std::array<double, CurveBuckets> curve_score{};         // share of correctly predicted bits, summed per bucket of passes
+        std::array<size_t, CurveBuckets> curve_passes{};
+        Histogram sequences_before_saturation;
+
+        void pass(size_t iteration, size_t score, size_t max_score)
+        {
+            const size_t bucket = std::min<size_t>(std::bit_width(iteration), CurveBuckets - 1);
+            curve_score[bucket] += max_score ? (double)score / max_score : 1.0;
+            ++curve_passes[bucket];
+        }
+        void episode(time_t time)
+        {
+            if (time < Infinity)
+                adaptation_times.add(time);
+            else
+                ++unlearned;
+        }
+        LearningTelemetry& operator+=(const LearningTelemetry& other)
+        {
+            adaptation_times += other.adaptation_times;
+            unlearned += other.unlearned;
+            for (size_t k = 0; k < CurveBuckets; ++k) {
+                curve_score[k] += other.curve_score[k];
+                curve_passes[k] += other.curve_passes[k];
+            }
+            sequences_before_saturation += other.sequences_before_saturation;
+            return *this;
+        }
+
+        std::string report() const
+        {
+            std::string text = std::format("{}\nAdaptation time in timesteps: {} sequences learned (mean {:.1f}), {} not learned\n{}",
+                yellow("Learning telemetry"), adaptation_times.count(), adaptation_times.mean(), unlearned, adaptation_times.render());
+
+            text += "Learning curve: correctly predicted bits per pass\n";
+            for (size_t k = 0; k < CurveBuckets; ++k) {
+                if (curve_passes[k] == 0)
+                    continue;
+                const size_t lo = k ? size_t{ 1 } << (k - 1) : 0, hi = k + 1 < CurveBuckets ? (k ? (lo << 1) - 1 : 0) : Infinity;
+                const std::string passes = lo == hi ? std::format("{}", lo) : hi == Infinity ? std::format("{}+", lo) : std::format("{}-{}", lo, hi);
+                text += std::format("{:>24}{:>9.1f}%  ({} passes)\n", passes, 100.0 * curve_score[k] / curve_passes[k], curve_passes[k]);
+            }
+
+            if (sequences_before_saturation.count() > 0)
+                text += std::format("Sequences learned before saturation (mean {:.1f})\n{}",
+                    sequences_before_saturation.mean(), sequences_before_saturation.render());
+            return text;
+        }
+    };
+
+    inline std::mutex telemetry_mutex;
+    inline LearningTelemetry telemetry_total;
+    struct TelemetrySink
+    {
+        LearningTelemetry data;
+        ~TelemetrySink()
+        {
+            std::lock_guard lock(telemetry_mutex);
+            telemetry_total += data;
+        }
+    };
+    inline thread_local TelemetrySink telemetry_sink;
+
+    // The telemetry of the calling thread.
+    inline LearningTelemetry& telemetry() { return telemetry_sink.data; }
+    // The telemetry of all finished threads and the calling one.
+    inline LearningTelemetry collected_telemetry()
+    {
+        std::lock_guard lock(telemetry_mutex);
+        LearningTelemetry total = telemetry_total;
+        return total += telemetry();
+    }
+    // Clears the telemetry of all finished threads and the calling one.
+    inline void reset_telemetry()
+    {
+        std::lock_guard lock(telemetry_mutex);
+        telemetry_total = {};
+        telemetry() = {};
+    }
+
+/**
+ * Memo of the transitions of a deterministic model, shared by all threads: (state, input) -> (successor, prediction).
+ *
+ * The tests feed the same inputs to the same states over and over: fresh models start every sequence, and
+ * copies of one model receive the same inputs. A transition is looked up by the fingerprint of the state
+ * and the input, and confirmed by comparing the state itself, so that colliding fingerprints never yield a
+ * wrong successor. Entries are spread over independently locked shards, each of which evicts its least
+ * recently used entry once its share of the memory budget is spent.
+ **/
+    template <typename State, typename Input>
+    class TransitionCache
+    {
+    public:
+        // Sets the memory budget in bytes, given the memory of one state; 0 disables and empties the cache.
+        void resize(size_t budget, size_t state_bytes)
+        {
+            const size_t entry_bytes = sizeof(Entry) + 2 * std::max(state_bytes, sizeof(State)) + NodeOverhead;
+            const size_t capacity = budget / entry_bytes / Shards;
+            if (capacity == shard_capacity)
+                return;
+
+            for (Shard& shard : shards) {
+                std::lock_guard lock(shard.mutex);
+                while (shard.lru.size() > capacity)
+                    evict(shard);
+            }
+            shard_capacity = capacity;
+        }
+        bool enabled() const { return shard_capacity > 0; }
+
+        // Replaces a known state with its successor on the given input and returns the prediction that
+        // accompanies the transition; returns nothing if the transition is not in the cache.
+        std::optional<Input> replay(State& state, size_t& state_hash, const Input& input)
+        {
+            const size_t key = key_of(state_hash, input);
+            Shard& shard = shards[key % Shards];
+            std::lock_guard lock(shard.mutex);
+
+            const auto entry = find(shard, key, state, input);
+            if (entry == shard.lru.end())
+                return std::nullopt;
+
+            shard.lru.splice(shard.lru.begin(), shard.lru, entry);
+            state = entry->successor;
+            state_hash = entry->successor_hash;
+            return entry->prediction;
+        }
+
+        void record(const State& predecessor, size_t predecessor_hash, const Input& input, const State& successor, size_t successor_hash, const Input& prediction)
+        {
+            const size_t key = key_of(predecessor_hash, input);
+            Shard& shard = shards[key % Shards];
+            std::lock_guard lock(shard.mutex);
+
+            const size_t capacity = shard_capacity;
+            if (capacity == 0 or find(shard, key, predecessor, input) != shard.lru.end())
+                return;
+            while (shard.lru.size() >= capacity)
+                evict(shard);
+
+            on_heap([&]() { shard.lru.emplace_front(key, input, predecessor, successor, successor_hash, prediction); });
+            shard.index.emplace(key, shard.lru.begin());
+        }
+
+    private:
+        static constexpr size_t Shards = 16, NodeOverhead = 8 * sizeof(void*);
+
+        struct Entry
+        {
+            size_t key;
+            Input input;
+            State predecessor, successor;
+            size_t successor_hash;
+            Input prediction;
+        };
+        using Entries = std::list<Entry>;
+        struct Shard
+        {
+            std::mutex mutex;
+            Entries lru;                                            // most recently used first
+            std::unordered_multimap<size_t, typename Entries::iterator> index;
+        };
+
+        std::array<Shard, Shards> shards;
+        std::atomic<size_t> shard_capacity = 0;
+
+        static size_t key_of(size_t state_hash, const Input& input)
+        {
+            return state_hash ^ (std::hash<Input>{}(input) + 0x9e3779b97f4a7c15 + (state_hash << 6) + (state_hash >> 2));
+        }
+        static typename Entries::iterator find(Shard& shard, size_t key, const State& state, const Input& input)
+        {
+            const auto [first, last] = shard.index.equal_range(key);
+            const auto match = std::find_if(first, last, [&](const auto& entry) {
+                return entry.second->input == input and equal_states(entry.second->predecessor, state);
+            });
+            return match == last ? shard.lru.end() : match->second;
+        }
+        static void evict(Shard& shard)
+        {
+            const auto oldest = std::prev(shard.lru.end());
+            const auto [first, last] = shard.index.equal_range(oldest->key);
+            shard.index.erase(std::find_if(first, last, [&](const auto& entry) { return entry.second == oldest; }));
+            shard.lru.erase(oldest);
+        }
+    };
+
+/**
+ * Explicit transition graph of a finite-state model: every state reachable from the initial one, with its
+ * successor and prediction for every input. It is built once, by a breadth-first search that steps each
+ * reachable state with each input twice, which also tells whether the model is deterministic on all of its
+ * reachable states. The search gives up, leaving the graph incomplete, once it finds more states than the
+ * model declares or than fit the memory budget, or if the input space is too large to enumerate.
+ **/
+    template <typename State, typename Input>
+    class StateGraph
+    {
+    public:
+        using node = uint32_t;
+        static constexpr size_t MaxInputBits = 16;
+
+        StateGraph(const State& initial, size_t max_states, size_t memory_budget)
+            : inputs(Input{}.size() <= MaxInputBits ? size_t{ 1 } << Input{}.size() : 0)
+        {
+            if (inputs == 0 or max_states == 0 or max_states > std::numeric_limits<node>::max())
+                return;
+            const size_t bytes_per_state = sizeof(State) + 4 * sizeof(void*) + inputs * (sizeof(node) + sizeof(Input));
+            max_states = std::min(max_states, memory_budget / bytes_per_state);
+            if (max_states == 0)
+                return;
+
+            add(initial, fingerprint_of(initial));
+            for (node n = 0; n < states.size(); ++n) {
+                for (size_t i = 0; i < inputs; ++i) {
+                    State A = states[n], B = states[n];
+                    const Input prediction = A(Input(i));
+                    is_deterministic = is_deterministic and prediction == B(Input(i)) and equal_states(A, B);
+
+                    const size_t hash = fingerprint_of(A);
+                    std::optional<node> successor = find(A, hash);
+                    if (not successor) {
+                        if (states.size() == max_states) {
+                            *this = StateGraph();
+                            return;
+                        }
+                        successor = add(A, hash);
+                    }
+                    successors.push_back(*successor);
+                    predictions.push_back(prediction);
+                }
+            }
+            is_complete = true;
+        }
+
+        // A complete graph holds all reachable states, the initial one being node 0.
+        bool complete() const { return is_complete; }
+        bool deterministic() const { return is_deterministic; }
+        size_t size() const { return states.size(); }
+
+        const State& state(node n) const { return states[n]; }
+        node successor(node n, const Input& x) const { return successors[n * inputs + x.to_ulong()]; }
+        const Input& prediction(node n, const Input& x) const { return predictions[n * inputs + x.to_ulong()]; }
+
+        std::optional<node> find(const State& state, size_t hash) const
+        {
+            const auto [first, last] = index.equal_range(hash);
+            const auto match = std::find_if(first, last, [&](const auto& entry) { return equal_states(states[entry.second], state); });
+            return match == last ? std::nullopt : std::optional<node>(match->second);
+        }
+        // Identifies a state together with the latest prediction, which is how models compare.
+        size_t key(node n, const Input& prediction) const { return n * inputs + prediction.to_ulong(); }
+
+        // Whether feeding x to the initial state `steps` times revisits a state, the latest prediction included.
+        bool revisits(const Input& x, size_t steps) const
+        {
+            std::unordered_set<size_t> visited;
+            node n = 0;
+            Input latest{};
+            for (size_t time = 0; time <= steps; ++time) {
+                if (not visited.insert(key(n, latest)).second)
+                    return true;
+                latest = prediction(n, x);
+                n = successor(n, x);
+            }
+            return false;
+        }
+
+    private:
+        size_t inputs = 0;
+        bool is_complete = false, is_deterministic = true;
+        std::vector<State> states;
+        std::unordered_multimap<size_t, node> index;
+        std::vector<node> successors;                               // [node * inputs + input]
+        std::vector<Input> predictions;
+
+        StateGraph() = default;
+
+        node add(const State& state, size_t hash)
+        {
+            states.push_back(state);
+            index.emplace(hash, (node)(states.size() - 1));
+            return (node)(states.size() - 1);
+        }
+    };
+
+    // Adapts a model that is constructed from a parameter point to the default construction that AGITB expects. The
+    // point is taken from the calling thread, where the harness that evaluates it sets Configured::configuration,
+    // and is kept in the model so that models of different points never compare equal. Constructing one on a thread
+    // without a parameter point fails its ASSERT, in every build.
+    template <typename ModelUnderTest, std::equality_comparable Parameters>
+        requires std::constructible_from<ModelUnderTest, const Parameters&>
+    struct Configured
+    {
+        using parameters_type = Parameters;
+        static inline thread_local const Parameters* configuration = nullptr;
+
+        Parameters parameters;
+        ModelUnderTest model;
+
+        Configured() : parameters((ASSERT(configuration != nullptr), *configuration)), model(parameters) {}
+        bool operator==(const Configured&) const = default;
+
+        template <typename Input>
+        Input operator()(const Input& x) { return model(x); }
+    };
+
+    // All parameter points of a grid, one for every combination of values along the axes, each point built as
+    // Parameters{ value of axis 1, value of axis 2, ... }.
+    template <typename Parameters, typename... Axes>
+    std::vector<Parameters> grid_points(const std::vector<Axes>&... axes)
+    {
+        const size_t count = (size_t{ 1 } * ... * axes.size());
+        std::vector<Parameters> points;
+        points.reserve(count);
+        for (size_t k = 0; k < count; ++k) {
+            size_t rest = k;
+            auto value = [&](const auto& axis) -> const auto& {
+                const size_t i = rest % axis.size();
+                rest /= axis.size();
+                return axis[i];
+            };
+            points.push_back(Parameters{ value(axes)... });
+        }
+        return points;
+    }
+    // A random search: `count` distinct points of the grid, or all of them if there are fewer, drawn uniformly from
+    // the given seed. Each point takes a value of every axis independently, so the grid is never enumerated.
+    template <typename Parameters, typename... Axes>
+    std::vector<Parameters> random_points(size_t count, unsigned seed, const std::vector<Axes>&... axes)
+    {
+        if ((axes.empty() or ...))
+            return {};
+        size_t grid = 1;                                                // saturating, as the grid may be vast
+        ((grid = grid > std::numeric_limits<size_t>::max() / axes.size() ? std::numeric_limits<size_t>::max() : grid * axes.size()), ...);
+        count = std::min(count, grid);
+
+        std::mt19937 engine(seed);
+        std::set<std::array<size_t, sizeof...(Axes)>> drawn;            // value indices of the points so far
+        std::vector<Parameters> points;
+        points.reserve(count);
+        while (points.size() < count) {
+            const std::array<size_t, sizeof...(Axes)> at = { std::uniform_int_distribution<size_t>(0, axes.size() - 1)(engine)... };
+            if (not drawn.insert(at).second)
+                continue;
+            size_t k = 0;
+            points.push_back(Parameters{ axes[at[k++]]... });
+        }
+        return points;
+    }
+
     template <typename ModelUnderTest, typename InputType, size_t SimulatedInfinity>
     requires InputPredictor<ModelUnderTest, InputType>
     class Model
@@ -157,7 +983,20 @@ inline namespace utils {
         Model(const Model& src) = default;
         Model(Model&& src) = default;
         Model& operator=(const Model& src) = default;
-        bool operator==(const Model& rhs) const = default;
+
+        static constexpr bool fingerprinted = Fingerprintable<ModelUnderTest>;
+
+        // Models that provide a state hash are first compared by their fingerprints, which rejects unequal
+        // models in O(1) once computed; only matching fingerprints fall through to the exact comparison.
+        bool operator==(const Model& rhs) const
+        {
+            if (current_prediction != rhs.current_prediction)
+                return false;
+            if constexpr (fingerprinted)
+                if (fingerprint() != rhs.fingerprint())
+                    return false;
+            return equal_states(model, rhs.model);
+        }
 
         //template<typename... Args>
         //Model(Args&&... args) : model(std::forward<Args>(args)...) {}
@@ -165,18 +1004,68 @@ inline namespace utils {
         // Constructs a randomly initialized model by feeding it with random inputs.
         Model(random_tag, const time_t warm_up) : Model()
         {
-            *this << InputSequence(InputSequence::random, warm_up);
+            *this << InputSequence::lazy(InputSequence::random, warm_up);
         }
         Model(random_tag) : Model(random, utils::random(0, SimulatedInfinity))
         {
         }
         
         //////////////
-        Input operator ()(const Input& p) { return current_prediction = model(p); }
-        Model& operator << (const Input& p) { current_prediction = model(p); return *this; }
+        Input operator ()(const Input& p) { return step(p); }
+        Model& operator << (const Input& p) { step(p); return *this; }
         ////////////////
         const Input& get_prediction() const { return current_prediction; }
 
+        // Returns the model to its uninformed start, equal to a default-constructed one. Depending on what was
+        // measured cheaper for the model type, it constructs a new model, copies a prototype into the recycled
+        // instance, or calls the model's own reset().
+        Model& reset()
+        {
+            switch (renewal()) {
+            case renewal_strategy::construct: model = ModelUnderTest{}; break;
+            case renewal_strategy::clone: model = prototype(); break;
+            case renewal_strategy::in_place: if constexpr (Resettable<ModelUnderTest>) model.reset(); break;
+            }
+            current_prediction = Input{};
+            fingerprint_valid = false;
+            return *this;
+        }
+
+        // Hash of the model state, computed at most once between two mutations of the model. A hash provided
+        // by the model takes precedence over hashing the bytes of a byte-comparable model.
+        size_t fingerprint() const
+            requires fingerprinted
+        {
+            if (not fingerprint_valid) {
+                state_hash = fingerprint_of(model);
+                fingerprint_valid = true;
+            }
+            return state_hash;
+        }
+
+        // Transitions memoized for the model type, shared by all threads; disabled until given a budget.
+        static TransitionCache<ModelUnderTest, Input>& transitions()
+            requires fingerprinted
+        {
+            static TransitionCache<ModelUnderTest, Input> cache;
+            return cache;
+        }
+
+        // The transition graph of a model type that declares its max_states, built on first use, or nullptr
+        // if the model has more reachable states than it declares or than fit the state_graph_budget, or is of
+        // another kind.
+        static const StateGraph<ModelUnderTest, Input>* state_graph()
+        {
+            if constexpr (FiniteState<ModelUnderTest> and EnumerableInput<Input>) {
+                static const StateGraph<ModelUnderTest, Input> graph = on_heap([]() {
+                    return StateGraph<ModelUnderTest, Input>(prototype(), ModelUnderTest::max_states, state_graph_budget);
+                });
+                return graph.complete() ? &graph : nullptr;
+            }
+            else
+                return nullptr;
+        }
+
         // Sequentially feeds each element of the range to the target.
         template <std::ranges::range Range>
             //requires std::same_as<std::ranges::range_value_t<Range>, Input>
@@ -189,11 +1078,12 @@ inline namespace utils {
 
         static InputSequence learnable_random_sequence(const size_t length)
         {
+            Model M;
             for (time_t time = 0; time < SimulatedInfinity; time += length) {
                 const InputSequence in = InputSequence(InputSequence::circular_random, length);
-                Model M;
                 if (M.learn(in))
                     return in;
+                M.reset();
             }
 
             const bool learned_at_least_one_sequence = false;
@@ -203,11 +1093,10 @@ inline namespace utils {
         // Adapts the model to the given input sequence and returns the number of timesteps needed to learn the sequence.
         time_t time_to_learn(const InputSequence& inputs)
         {
-            for (size_t iteration = 0; iteration < SimulatedInfinity; ++iteration) {
-                if (process(inputs) == inputs)
-                    return iteration * inputs.size();
-            }
-            return Infinity;
+            const time_t time = adapt(inputs);
+            if (record_telemetry)
+                telemetry().episode(time);
+            return time;
         }
 
         // Adapts the model to the given input sequence and returns true if perfect prediction is achieved.
@@ -216,6 +1105,18 @@ inline namespace utils {
             return time_to_learn(inputs) < Infinity;
         }
 
+        // Modifies the model by processing the given inputs and returns its corresponding predictions.
+        InputSequence process(const InputSequence& inputs)
+        {
+            InputSequence predictions; predictions.reserve(inputs.size());
+
+            for (const Input& in : inputs) {
+                predictions.push_back(get_prediction());
+                *this << in;
+            }
+            return predictions;
+        }
+
         bool behaves_identically(Model& B)
         {
             Input x = utils::random<Input>();
@@ -242,17 +1143,163 @@ inline namespace utils {
     private:
         ModelUnderTest model;
         Input current_prediction;
+        mutable size_t state_hash = 0;
+        mutable bool fingerprint_valid = false;
+
+        enum class renewal_strategy { construct, clone, in_place };
+
+        // Feeds one input to the model, replaying the transition where memoized transitions are enabled.
+        Input step(const Input& p)
+        {
+            if constexpr (fingerprinted) {
+                if (memoize_transitions and transitions().enabled()) {
+                    const size_t predecessor_hash = fingerprint();
+                    if (const auto prediction = transitions().replay(model, state_hash, p))
+                        return current_prediction = *prediction;      // the fingerprint stays valid
+
+                    const ModelUnderTest predecessor = model;
+                    current_prediction = model(p);
+                    fingerprint_valid = false;
+                    transitions().record(predecessor, predecessor_hash, p, model, fingerprint(), current_prediction);
+                    return current_prediction;
+                }
+            }
+            fingerprint_valid = false;
+            return current_prediction = model(p);
+        }
+
+        static const ModelUnderTest& prototype()
+        {
+            static const ModelUnderTest uninformed = on_heap([]() { return ModelUnderTest{}; });
+            return uninformed;
+        }
+        static renewal_strategy renewal()
+        {
+            if constexpr (Parameterised<ModelUnderTest>)
+                return renewal_strategy::construct;
+            else {
+                static const renewal_strategy cheapest = calibrate_renewal();
+                return cheapest;
+            }
+        }
+        // Times each strategy on a batch of recycled models and returns the cheapest one. A reset() that does not
+        // restore the uninformed start of the model is not a renewal, and is never chosen.
+        static renewal_strategy calibrate_renewal()
+        {
+            std::vector<ModelUnderTest> batch(16);
+            auto cost = [&](auto renew) {
+                const auto start = std::chrono::steady_clock::now();
+                for (size_t round = 0; round < 4; ++round)
+                    for (ModelUnderTest& m : batch)
+                        renew(m);
+                return std::chrono::steady_clock::now() - start;
+            };
+
+            renewal_strategy cheapest = renewal_strategy::construct;
+            auto fastest = cost([](ModelUnderTest& m) { m = ModelUnderTest{}; });
+            if (const auto t = cost([](ModelUnderTest& m) { m = prototype(); }); t < fastest)
+                cheapest = renewal_strategy::clone, fastest = t;
+            if constexpr (Resettable<ModelUnderTest>) {
+                const std::mt19937 saved = rng;             // informing the batch leaves the random generator untouched
+                for (ModelUnderTest& m : batch)
+                    for (size_t t = 0; t < SimulatedInfinity / 100; ++t)
+                        m(utils::random<Input>());
+                rng = saved;
+
+                const auto t = cost([](ModelUnderTest& m) { m.reset(); });
+                const bool reset_restores_uninformed_start = std::ranges::all_of(batch, [](const ModelUnderTest& m) { return m == prototype(); });
+                if (reset_restores_uninformed_start and t < fastest)
+                    cheapest = renewal_strategy::in_place, fastest = t;
+            }
+            return cheapest;
+        }
         
-        // Modifies the model by processing the given inputs and returns its corresponding predictions.
-        InputSequence process(const InputSequence& inputs)
+        // Passes over the input sequence until the model predicts all of it; returns the timesteps that took.
+        time_t adapt(const InputSequence& inputs)
         {
-            InputSequence predictions; predictions.reserve(inputs.size());
+            if constexpr (FiniteState<ModelUnderTest> and EnumerableInput<Input>)
+                if (const auto* graph = state_graph(); graph and graph->deterministic())
+                    if (const auto n = graph->find(model, fingerprint()))
+                        return adapt(*graph, *n, inputs);
 
-            for (const Input& in : inputs) {
-                predictions.push_back(get_prediction());
-                *this << in;
+            // A fingerprinted model is checked for a cycle of passes: the state at the start of a pass is compared
+            // with a checkpoint taken at passes 0, 1, 2, 4, 8, ... If it recurs, the model will never learn the
+            // sequence, and the few passes that bring it to the state the full loop would end in suffice.
+            std::optional<Model> checkpoint;
+            size_t checkpoint_iteration = 0;
+            size_t best_score = 0, stale_passes = 0;                    // approximate learning
+
+            for (size_t iteration = 0; iteration < SimulatedInfinity; ++iteration) {
+                if constexpr (fingerprinted) {
+                    if (checkpoint and *checkpoint == *this) {
+                        const size_t cycle = iteration - checkpoint_iteration;
+                        for (size_t remaining = (SimulatedInfinity - iteration) % cycle; remaining > 0; --remaining)
+                            process(inputs);
+                        return Infinity;
+                    }
+                    if ((iteration & (iteration - 1)) == 0) {
+                        checkpoint = *this;
+                        checkpoint_iteration = iteration;
+                    }
+                }
+                const InputSequence predictions = process(inputs);
+                if (record_telemetry)
+                    telemetry().pass(iteration, match_score(predictions, inputs), inputs.size() * Input{}.size());
+                if (predictions == inputs)
+                    return iteration * inputs.size();
+
+                if (plateau_patience > 0) {
+                    const size_t score = match_score(predictions, inputs);
+                    stale_passes = (iteration == 0 or score > best_score) ? 0 : stale_passes + 1;
+                    best_score = std::max(best_score, score);
+                    if (stale_passes == plateau_patience and iteration + 1 < SimulatedInfinity) {
+                        ++plateau_stops;
+                        plateau_steps_saved += (SimulatedInfinity - iteration - 1) * inputs.size();
+                        return Infinity;
+                    }
+                }
             }
-            return predictions;
+            return Infinity;
+        }
+
+        // adapt() by walking the transition graph instead of stepping the model; a pass that starts from
+        // a (state, prediction) pair seen before proves that the sequence will never be learned.
+        template <typename Graph>
+        time_t adapt(const Graph& graph, typename Graph::node n, const InputSequence& inputs)
+        {
+            Input latest = current_prediction;
+            const size_t max_score = inputs.size() * Input{}.size();
+            auto pass = [&]() {                                         // returns the match score of the pass
+                size_t score = 0;
+                for (const Input& x : inputs) {
+                    score += match_score(latest, x);
+                    latest = graph.prediction(n, x);
+                    n = graph.successor(n, x);
+                }
+                return score;
+            };
+            auto settle = [&](time_t time) {
+                model = graph.state(n);
+                current_prediction = latest;
+                fingerprint_valid = false;
+                return time;
+            };
+
+            std::unordered_map<size_t, size_t> passes;                  // (state, prediction) at the start of a pass -> pass
+            for (size_t iteration = 0; iteration < SimulatedInfinity; ++iteration) {
+                const auto [seen, first_visit] = passes.emplace(graph.key(n, latest), iteration);
+                if (not first_visit) {
+                    for (size_t remaining = (SimulatedInfinity - iteration) % (iteration - seen->second); remaining > 0; --remaining)
+                        pass();
+                    return settle(Infinity);
+                }
+                const size_t score = pass();
+                if (record_telemetry)
+                    telemetry().pass(iteration, score, max_score);
+                if (score == max_score)
+                    return settle(iteration * inputs.size());
+            }
+            return settle(Infinity);
         }
     };
 
@@ -342,6 +1389,49 @@ inline namespace utils {
         return z > one_sided_z_threshold;   // true => evidence that V2 tends to be greater than V1
     }
 
+/**
+ * Wald's sequential probability ratio test on the failure rate of repeated pass/fail trials.
+ *
+ * The null hypothesis H0 states that trials fail with the (small) rate p0, the alternative H1 that
+ * they fail with the rate p1 > p0. After each observed trial the log-likelihood ratio of H1 over H0
+ * is compared with the Wald boundaries, which keep the probability of rejecting a true H0 below
+ * alpha and the probability of accepting a false H0 below beta. The test therefore stops as soon as
+ * the evidence suffices, which for clearly passing or clearly failing subjects takes a small fraction
+ * of a fixed-size experiment.
+ **/
+    class SequentialProbabilityRatioTest
+    {
+    public:
+        enum verdict { undecided, accept, reject };     // accept or reject H0
+
+        SequentialProbabilityRatioTest(double p0, double p1, double alpha, double beta)
+            : pass_weight(std::log((1 - p1) / (1 - p0))), fail_weight(std::log(p1 / p0)),
+              lower(std::log(beta / (1 - alpha))), upper(std::log((1 - beta) / alpha))
+        {
+            assert(0 < p0 and p0 < p1 and p1 < 1);
+        }
+
+        verdict observe(bool failed)
+        {
+            llr += failed ? fail_weight : pass_weight;
+            return current();
+        }
+        verdict current() const
+        {
+            return llr >= upper ? reject : llr <= lower ? accept : undecided;
+        }
+        // The verdict of a test cut short before reaching either boundary: the more likely hypothesis wins.
+        verdict truncated() const
+        {
+            return current() != undecided ? current() : llr > 0 ? reject : accept;
+        }
+
+    private:
+        double pass_weight, fail_weight;
+        double lower, upper;
+        double llr = 0.0;
+    };
+
     template <std::ranges::range Range>
         //requires std::same_as<std::ranges::range_value_t<Range>, double>
     auto percentiles(Range&& times)
@@ -355,6 +1445,41 @@ inline namespace utils {
         return std::make_tuple(p50, p95);
     }
 
+    // Calls f(i) for every i in [0, count) on up to max_workers threads, including the calling one.
+    // Returning false from f stops the calls that have not started yet.
+    template <typename Func>
+    void parallel_for(size_t count, Func&& f, size_t max_workers = std::thread::hardware_concurrency())
+    {
+        std::atomic<size_t> next = 0;
+        std::atomic<bool> stop = false;
+        auto worker = [&]() {
+            for (size_t i; not stop and (i = next++) < count; )
+                if (not f(i))
+                    stop = true;
+        };
+
+        std::vector<std::jthread> helpers(std::clamp<size_t>(max_workers, 1, std::max<size_t>(count, 1)) - 1);
+        for (std::jthread& helper : helpers)
+            helper = std::jthread(worker);
+        worker();
+    }
+
+    // Returns the resident memory of the process in bytes, or 0 where the platform does not tell.
+    inline size_t resident_memory()
+    {
+#ifdef __linux__
+        size_t total_pages = 0, resident_pages = 0;
+        if (std::FILE* statm = std::fopen("/proc/self/statm", "r")) {
+            if (std::fscanf(statm, "%zu %zu", &total_pages, &resident_pages) != 2)
+                resident_pages = 0;
+            std::fclose(statm);
+        }
+        return resident_pages * (size_t)sysconf(_SC_PAGESIZE);
+#else
+        return 0;
+#endif
+    }
+
     template <typename Func>
     time_t time_it(Func&& f) 
     {